@@ -0,0 +1,193 @@
+#pragma once
+
+#include "graph.h"
+#include "dijkstra.h"
+
+#include <algorithm>
+#include <bitset>
+#include <iterator>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+/**
+ * @file alternatives.h
+ * @brief Несколько заметно различающихся путей между парой вершин (метод штрафов).
+ *
+ * Первый путь — кратчайший. Затем веса рёбер каждого найденного пути
+ * умножаются на штраф, и поиск повторяется: следующий путь обходит уже
+ * использованные участки, если объезд не слишком дорог. Кандидат принимается,
+ * если его настоящий вес не больше max_stretch от кратчайшего и он делит
+ * с каждым принятым путём не больше max_overlap своего веса.
+ *
+ * Единственное исходящее ребро вершины не штрафуется: его не обойти.
+ * Штрафы только увеличивают веса, поэтому согласованная эвристика A*
+ * (например, graph::LandmarkIndex::Potential) остаётся согласованной
+ * и используется во всех поисках.
+ *
+ * Работа на запрос ограничена: не больше max_searches поисков и не больше
+ * max_work_factor раскрытых вершин относительно первого поиска (поиск,
+ * исчерпавший остаток лимита, прерывается). Поэтому время запроса —
+ * не больше (1 + max_work_factor) поисков кратчайшего пути.
+ *
+ * @tparam Weight — тип веса рёбер (должен поддерживать операции +, <, умножение на double)
+ */
+
+namespace graph {
+
+	/// Критерии различия путей и ограничения работы FindAlternativePaths
+	struct AlternativePathOptions {
+		double penalty_factor = 1.25;    ///< Множитель веса ребра за каждый найденный путь через него
+		double max_stretch = 1.5;       ///< Наибольший вес альтернативы относительно кратчайшего пути
+		double max_overlap = 0.7;       ///< Наибольшая доля веса альтернативы, общая с принятым путём
+		size_t max_searches = 12;       ///< Наибольшее число поисков (включая первый)
+		size_t max_work_factor = 8;     ///< Раскрыто вершин всего — не больше стольких первых поисков
+	};
+
+	/// Считает новым любой путь (FindAlternativePaths без дополнительного фильтра)
+	struct AnyPathIsDistinct {
+		template <typename RouteInfo>
+		bool operator()(const std::vector<EdgeId>&, const std::vector<RouteInfo>&) const {
+			return true;
+		}
+	};
+
+	/**
+	 * @brief Находит до count различающихся путей из from в to.
+	 *
+	 * @param potential Согласованная нижняя оценка веса пути до to (как в FindShortestPath)
+	 * @param is_distinct Дополнительный фильтр: is_distinct(рёбра кандидата, принятые пути) —
+	 *        false, если путь не считается новым (например, совпадает с принятым по смыслу)
+	 * @param searches Если задан — сюда записывается число выполненных поисков
+	 * @param counters Если задан — к нему прибавляются счётчики всех поисков
+	 * @return Пути по неубыванию настоящего веса; первый — кратчайший.
+	 *         Пусто, если to недостижима
+	 * @throw std::out_of_range, если вершина вне графа
+	 */
+	template <typename Weight, typename Potential = ZeroPotential<Weight>, typename Filter = AnyPathIsDistinct>
+	std::vector<typename ShortestPathTree<Weight>::RouteInfo> FindAlternativePaths(
+		const DirectedWeightedGraph<Weight>& graph, VertexId from, VertexId to, size_t count,
+		const AlternativePathOptions& options = {}, const Potential& potential = {},
+		const Filter& is_distinct = {}, size_t* searches = nullptr, SearchCounters* counters = nullptr);
+
+	// ====================================================
+	// Реализация
+	// ====================================================
+
+	template <typename Weight, typename Potential, typename Filter>
+	std::vector<typename ShortestPathTree<Weight>::RouteInfo> FindAlternativePaths(
+		const DirectedWeightedGraph<Weight>& graph, VertexId from, VertexId to, size_t count,
+		const AlternativePathOptions& options, const Potential& potential,
+		const Filter& is_distinct, size_t* searches, SearchCounters* counters) {
+		using RouteInfo = typename ShortestPathTree<Weight>::RouteInfo;
+
+		std::vector<RouteInfo> result;
+		size_t search_count = 0;
+		if (count == 0) {
+			if (searches) {
+				*searches = 0;
+			}
+			return result;
+		}
+
+		// Штрафы затрагивают только рёбра найденных путей — их немного. Битовый фильтр
+		// по младшим битам ID отсекает почти все рёбры без штрафа без обращения к словарю
+		constexpr size_t FILTER_SIZE = 4096;
+		std::bitset<FILTER_SIZE> penalized;
+		std::unordered_map<EdgeId, double> penalties;
+		auto penalized_weight = [&](EdgeId edge_id, const Edge<Weight>& edge) {
+			if (!penalized.test(edge_id % FILTER_SIZE)) {
+				return edge.weight;
+			}
+			auto it = penalties.find(edge_id);
+			return it == penalties.end() ? edge.weight : static_cast<Weight>(edge.weight * it->second);
+		};
+
+		// Принятые пути как множества рёбер — для доли общего веса
+		std::vector<std::unordered_set<EdgeId>> accepted_edges;
+		auto overlaps = [&](const RouteInfo& candidate) {
+			for (const auto& edges : accepted_edges) {
+				Weight shared{};
+				for (EdgeId edge_id : candidate.edges) {
+					if (edges.count(edge_id)) {
+						shared = shared + graph.GetEdge(edge_id).weight;
+					}
+				}
+				if (candidate.weight * options.max_overlap < shared) {
+					return true;
+				}
+			}
+			return false;
+		};
+
+		size_t work_budget = 0;
+		size_t work_done = 0;
+		std::optional<Weight> best_weight;
+
+		while (result.size() < count && search_count < options.max_searches
+			&& (search_count == 0 || work_done < work_budget)) {
+			SearchCounters work;
+			auto path = search_count == 0
+				? FindShortestPath(graph, from, to, potential, &work)
+				: FindShortestPath(graph, from, to, potential, &work, penalized_weight, work_budget - work_done);
+			++search_count;
+			work_done += work.settled;
+			if (search_count == 1) {
+				work_budget = work.settled * options.max_work_factor;
+			}
+			if (counters) {
+				counters->settled += work.settled;
+				counters->relaxed += work.relaxed;
+				counters->heap_pushes += work.heap_pushes;
+				counters->heap_pops += work.heap_pops;
+			}
+			if (!path) {
+				break;  // Цель недостижима (штрафы достижимость не меняют) или лимит исчерпан
+			}
+
+			// Вес со штрафами для остановки поиска не годится: рёбра, общие для всех путей
+			// (например, единственный выход из from), штрафуются каждый раз. Считаем настоящий
+			Weight weight{};
+			for (EdgeId edge_id : path->edges) {
+				weight = weight + graph.GetEdge(edge_id).weight;
+			}
+			path->weight = weight;
+
+			const bool accepted = !best_weight
+				|| (!(*best_weight * options.max_stretch < weight) && !overlaps(*path) && is_distinct(path->edges, result));
+			for (EdgeId edge_id : path->edges) {
+				// Единственный выход из вершины есть у любого пути через неё: штраф
+				// не меняет выбор, а только ослабляет эвристику и расширяет поиск
+				const auto outgoing = graph.GetIncidentEdges(graph.GetEdge(edge_id).from);
+				if (std::next(outgoing.begin()) == outgoing.end()) {
+					continue;
+				}
+				auto [it, inserted] = penalties.emplace(edge_id, options.penalty_factor);
+				if (!inserted) {
+					it->second *= options.penalty_factor;
+				}
+				penalized.set(edge_id % FILTER_SIZE);
+			}
+			if (!accepted) {
+				continue;
+			}
+
+			if (!best_weight) {
+				best_weight = weight;
+			}
+			accepted_edges.emplace_back(path->edges.begin(), path->edges.end());
+			result.push_back(std::move(*path));
+		}
+
+		// Поиски со штрафами могут найти более длинный путь раньше более короткого
+		std::stable_sort(result.begin() + std::min<size_t>(1, result.size()), result.end(),
+			[](const RouteInfo& lhs, const RouteInfo& rhs) { return lhs.weight < rhs.weight; });
+
+		if (searches) {
+			*searches = search_count;
+		}
+		return result;
+	}
+
+}  // namespace graph
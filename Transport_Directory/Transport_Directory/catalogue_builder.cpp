@@ -0,0 +1,149 @@
+#include "catalogue_builder.h"
+
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace trans_cat {
+
+	namespace {
+
+		// Сколько ошибок перечислять в сообщении исключения
+		constexpr size_t MAX_REPORTED_ERRORS = 10;
+
+		std::string Quote(std::string_view text) {
+			return "'" + std::string(text) + "'";
+		}
+
+		std::string JoinErrors(const std::vector<std::string>& errors) {
+			std::string message = "Invalid catalogue data: ";
+			const size_t shown = std::min(errors.size(), MAX_REPORTED_ERRORS);
+			for (size_t i = 0; i < shown; ++i) {
+				if (i > 0) {
+					message += "; ";
+				}
+				message += errors[i];
+			}
+			if (errors.size() > shown) {
+				message += "; ... and " + std::to_string(errors.size() - shown) + " more";
+			}
+			return message;
+		}
+
+	} // namespace
+
+	void CatalogueBuilder::Reserve(size_t stop_count, size_t route_count, size_t distance_count) {
+		stops_.reserve(stop_count);
+		routes_.reserve(route_count);
+		distances_.reserve(distance_count);
+	}
+
+	void CatalogueBuilder::AddStop(std::string_view name, geo::Coordinates coords) {
+		stops_.push_back(StopInput{ name, coords });
+	}
+
+	void CatalogueBuilder::SetDistance(std::string_view from, std::string_view to, int distance) {
+		distances_.push_back(DistanceInput{ from, to, distance });
+	}
+
+	void CatalogueBuilder::AddRoute(std::string_view name, std::vector<std::string_view> stops, bool is_roundtrip) {
+		routes_.push_back(RouteInput{ name, std::move(stops), is_roundtrip });
+	}
+
+	void CatalogueBuilder::Build(TransportCatalogue& catalogue) const {
+		if (!catalogue.stops_.empty() || !catalogue.routes_.empty()) {
+			throw std::logic_error("CatalogueBuilder: catalogue is not empty");
+		}
+
+		std::vector<std::string> errors;
+
+		// Остановки: индекс имён заполняется сразу под итоговый размер
+		catalogue.stopname_to_stop_.reserve(stops_.size());
+		for (const StopInput& input : stops_) {
+			const Stop& stop = catalogue.stops_.emplace_back(
+				Stop{ catalogue.names_.Store(input.name), input.coordinates, geo::ToUnitVector(input.coordinates),
+					static_cast<uint32_t>(catalogue.stops_.size()) });
+			if (!catalogue.stopname_to_stop_.emplace(stop.name, &stop).second) {
+				errors.push_back("duplicate stop " + Quote(input.name));
+			}
+		}
+
+		// Расстояния: повторное задание пары перезаписывает значение, как и SetDistance
+		std::vector<DistanceEntry> distance_entries;
+		distance_entries.reserve(distances_.size());
+		for (const DistanceInput& input : distances_) {
+			const Stop* from = catalogue.FindStop(input.from);
+			const Stop* to = catalogue.FindStop(input.to);
+			if (!from || !to) {
+				errors.push_back("distance " + Quote(input.from) + " -> " + Quote(input.to)
+					+ " refers to unknown stop " + Quote(from ? input.to : input.from));
+				continue;
+			}
+			if (input.distance < 0) {
+				errors.push_back("negative distance " + Quote(input.from) + " -> " + Quote(input.to));
+				continue;
+			}
+			distance_entries.push_back(DistanceEntry{ from->id, to->id, input.distance });
+		}
+		catalogue.distances_.Assign(catalogue.stops_.size(), std::move(distance_entries));
+
+		// Маршруты: имена остановок разрешаются в указатели, пары (остановка, маршрут) копятся для индекса
+		size_t total_stops = 0;
+		for (const RouteInput& input : routes_) {
+			total_stops += input.stops.size();
+		}
+
+		std::vector<StopRouteEntry> stop_routes;
+		stop_routes.reserve(total_stops);
+		catalogue.routename_to_route_.reserve(routes_.size());
+
+		for (const RouteInput& input : routes_) {
+			if (input.stops.empty()) {
+				errors.push_back("route " + Quote(input.name) + " has no stops");
+				continue;
+			}
+
+			std::vector<const Stop*> stop_ptrs;
+			stop_ptrs.reserve(input.stops.size());
+			for (std::string_view stop_name : input.stops) {
+				if (const Stop* stop = catalogue.FindStop(stop_name)) {
+					stop_ptrs.push_back(stop);
+				}
+				else {
+					errors.push_back("route " + Quote(input.name) + " refers to unknown stop " + Quote(stop_name));
+				}
+			}
+			if (stop_ptrs.size() != input.stops.size()) {
+				continue;
+			}
+
+			const Route& route = catalogue.routes_.emplace_back(
+				Route{ catalogue.names_.Store(input.name), std::move(stop_ptrs), input.is_roundtrip });
+			if (!catalogue.routename_to_route_.emplace(route.name, &route).second) {
+				errors.push_back("duplicate route " + Quote(input.name));
+				continue;
+			}
+			for (const Stop* stop : route.stops) {
+				stop_routes.push_back(StopRouteEntry{ stop->id, &route });
+			}
+		}
+
+		if (!errors.empty()) {
+			// Возвращаем каталог в исходное (пустое) состояние
+			catalogue.stop_to_routes_.Clear();
+			catalogue.distances_.Clear();
+			catalogue.routename_to_route_.clear();
+			catalogue.stopname_to_stop_.clear();
+			catalogue.routes_.clear();
+			catalogue.stops_.clear();
+			catalogue.names_ = StringArena{};
+			throw std::invalid_argument(JoinErrors(errors));
+		}
+
+		// Индекс "остановка → маршруты" строится сразу в виде массива (CSR) одной сортировкой
+		catalogue.stop_to_routes_.Assign(catalogue.stops_.size(), std::move(stop_routes));
+	}
+
+} // namespace trans_cat
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "transport_catalogue.h"
+
+#include <string_view>
+#include <vector>
+
+namespace trans_cat {
+
+	/**
+	 * @brief Пакетная загрузка транспортного каталога.
+	 *
+	 * В отличие от поштучных AddStop/SetDistance/AddRoute, сначала собирает
+	 * все остановки, расстояния и маршруты, а затем строит каталог за один раз:
+	 * - все контейнеры резервируются под итоговый размер;
+	 * - имена остановок разрешаются в указатели одним проходом;
+	 * - индекс "остановка → маршруты" строится сортировкой, а не вставками в дерево;
+	 * - подписчики не оповещаются — загрузка считается начальным состоянием.
+	 *
+	 * Вход проверяется целиком: неизвестные остановки в маршрутах и расстояниях,
+	 * повторяющиеся имена, пустые маршруты и отрицательные расстояния — ошибка
+	 * (в поштучном режиме неизвестные остановки молча создавались как заглушки).
+	 * json_reader::JSONReader в нестрогом режиме при такой ошибке загружает те же данные
+	 * поштучно, так что строгость остаётся выбором вызывающего кода.
+	 *
+	 * @note Строки передаются как string_view и не копируются до вызова Build —
+	 *       они должны оставаться валидными до его завершения (например, жить в json::Document).
+	 *
+	 * @example
+	 * CatalogueBuilder builder;
+	 * builder.AddStop("A", { 55.6, 37.2 });
+	 * builder.AddStop("B", { 55.6, 37.3 });
+	 * builder.SetDistance("A", "B", 1000);
+	 * builder.AddRoute("1", { "A", "B" }, false);
+	 * builder.Build(catalogue);
+	 */
+	class CatalogueBuilder {
+	public:
+		/// Резервирует место под ожидаемое число объектов (необязательно)
+		void Reserve(size_t stop_count, size_t route_count, size_t distance_count);
+
+		void AddStop(std::string_view name, geo::Coordinates coords);
+		void SetDistance(std::string_view from, std::string_view to, int distance);
+		void AddRoute(std::string_view name, std::vector<std::string_view> stops, bool is_roundtrip);
+
+		/**
+		 * @brief Проверяет собранные данные и заполняет ими каталог.
+		 * @param catalogue Пустой каталог
+		 * @throw std::invalid_argument если данные некорректны (в сообщении — все найденные ошибки)
+		 * @throw std::logic_error если каталог не пуст
+		 */
+		void Build(TransportCatalogue& catalogue) const;
+
+	private:
+		struct StopInput {
+			std::string_view name;
+			geo::Coordinates coordinates;
+		};
+
+		struct DistanceInput {
+			std::string_view from;
+			std::string_view to;
+			int distance;
+		};
+
+		struct RouteInput {
+			std::string_view name;
+			std::vector<std::string_view> stops;
+			bool is_roundtrip;
+		};
+
+		std::vector<StopInput> stops_;
+		std::vector<DistanceInput> distances_;
+		std::vector<RouteInput> routes_;
+	};
+
+} // namespace trans_cat
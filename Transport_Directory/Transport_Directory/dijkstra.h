@@ -0,0 +1,377 @@
+#pragma once
+
+#include "graph.h"
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <queue>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+/**
+ * @file dijkstra.h
+ * @brief Поиск кратчайших путей из одной вершины (алгоритм Дейкстры).
+ *
+ * В отличие от graph::Router, который при создании считает пути между всеми
+ * парами вершин, ShortestPathTree выполняет один поиск из заданной вершины.
+ * Этого достаточно, чтобы за один проход получить время до множества вершин
+ * (запросы "один ко многим") и восстановить пути до любой из них.
+ *
+ * FindShortestPath — поиск между парой вершин, останавливающийся, как только
+ * зафиксирована конечная вершина; не требует памяти сверх O(V). С эвристикой
+ * (см. landmarks.h) это поиск A*.
+ *
+ * @tparam Weight — тип веса рёбер (должен поддерживать операции +, <, =)
+ */
+
+namespace graph {
+
+	/// Счётчики работы одного поиска (для диагностики медленных запросов)
+	struct SearchCounters {
+		size_t settled = 0;       ///< Раскрыто вершин
+		size_t relaxed = 0;       ///< Просмотрено рёбер
+		size_t heap_pushes = 0;   ///< Вставок в очередь с приоритетом
+		size_t heap_pops = 0;     ///< Извлечений из очереди (вместе с устаревшими записями)
+	};
+
+	/**
+	 * @brief Дерево кратчайших путей из одной вершины.
+	 *
+	 * Строится при создании объекта. Поиск можно ограничить максимальным весом:
+	 * вершины дальше порога не раскрываются и считаются недостижимыми.
+	 *
+	 * @note Граф должен иметь неотрицательные веса рёбер.
+	 * @note Сложность построения: O((V + E) log V), запроса веса: O(1),
+	 *       восстановления пути: O(L), где L — длина маршрута.
+	 */
+	template <typename Weight>
+	class ShortestPathTree {
+	private:
+		using Graph = DirectedWeightedGraph<Weight>;  ///< Удобный псевдоним
+
+	public:
+		/// Данные о найденном маршруте (совпадают с graph::Router::RouteInfo)
+		struct RouteInfo {
+			Weight weight;				///< Суммарный вес маршрута
+			std::vector<EdgeId> edges;	///< Последовательность рёбер маршрута
+		};
+
+		/**
+		 * @brief Выполняет поиск из вершины source.
+		 * @param graph Константная ссылка на граф (должна пережить дерево)
+		 * @param source Начальная вершина
+		 * @param max_weight Порог веса: более дальние вершины не раскрываются
+		 * @throw std::domain_error, если встречено ребро с отрицательным весом
+		 */
+		ShortestPathTree(const Graph& graph, VertexId source,
+			std::optional<Weight> max_weight = std::nullopt);
+
+		/// Начальная вершина поиска
+		VertexId GetSource() const;
+
+		/**
+		 * @brief Возвращает вес кратчайшего пути до вершины.
+		 * @return std::nullopt, если вершина недостижима (или дальше порога)
+		 */
+		std::optional<Weight> GetWeight(VertexId to) const;
+
+		/**
+		 * @brief Возвращает последнее ребро кратчайшего пути до вершины.
+		 * @return std::nullopt для source и недостижимых вершин
+		 */
+		std::optional<EdgeId> GetPrevEdge(VertexId to) const;
+
+		/**
+		 * @brief Восстанавливает кратчайший путь до вершины.
+		 * @return RouteInfo — если путь существует; std::nullopt — если недостижима
+		 */
+		std::optional<RouteInfo> BuildRoute(VertexId to) const;
+
+		/**
+		 * @brief Вершины в порядке окончательной фиксации расстояний.
+		 *
+		 * Первой идёт source, далее — по неубыванию веса пути.
+		 */
+		const std::vector<VertexId>& GetSettledVertices() const;
+
+		/// Счётчики работы поиска
+		const SearchCounters& GetCounters() const;
+
+	private:
+		/// Элемент очереди с приоритетом: (вес пути, вершина)
+		using QueueItem = std::pair<Weight, VertexId>;
+
+		void Run(std::optional<Weight> max_weight);
+
+		static constexpr Weight ZERO_WEIGHT{};  ///< Нулевой вес (для начальной инициализации)
+
+		const Graph& graph_;                            ///< Граф, в котором ищем пути
+		VertexId source_;                               ///< Начальная вершина
+		std::vector<std::optional<Weight>> weights_;    ///< Лучший известный вес до вершины
+		std::vector<std::optional<EdgeId>> prev_edge_;  ///< Последнее ребро кратчайшего пути
+		std::vector<VertexId> settled_;                 ///< Порядок фиксации вершин
+		SearchCounters counters_;                       ///< Работа поиска
+	};
+
+	/// Нулевая эвристика: FindShortestPath с ней — обычный алгоритм Дейкстры
+	template <typename Weight>
+	struct ZeroPotential {
+		Weight operator()(VertexId) const {
+			return Weight{};
+		}
+	};
+
+	/// Вес ребра, хранящийся в графе (FindShortestPath по умолчанию)
+	template <typename Weight>
+	struct GraphEdgeWeight {
+		Weight operator()(EdgeId, const Edge<Weight>& edge) const {
+			return edge.weight;
+		}
+	};
+
+	/**
+	 * @brief Находит кратчайший путь между двумя вершинами.
+	 *
+	 * Поиск A* из from, прекращаемый при фиксации вершины to: вершины
+	 * раскрываются по возрастанию "вес пути + potential(вершина)".
+	 * С нулевой эвристикой это поиск Дейкстры, раскрывающий только вершины ближе to.
+	 *
+	 * @param potential Нижняя оценка веса пути от вершины до to; должна быть
+	 *        согласованной: potential(u) <= вес(u→v) + potential(v) для каждого ребра
+	 *        (например, graph::LandmarkIndex::Potential). Бесконечная оценка означает,
+	 *        что to из вершины недостижима: такие вершины не раскрываются
+	 * @param counters Если задан — сюда записываются счётчики работы поиска
+	 * @param edge_weight Вес ребра для поиска: edge_weight(id, ребро). Позволяет искать
+	 *        с изменёнными весами (например, со штрафами, см. alternatives.h), не копируя граф;
+	 *        potential должна оставаться согласованной с этими весами.
+	 *        Вес результата — в этих же весах
+	 * @param max_settled Наибольшее число раскрытых вершин: поиск, исчерпавший его
+	 *        до фиксации to, прекращается (std::nullopt, counters->settled == max_settled)
+	 * @return RouteInfo — если путь существует; std::nullopt — если недостижима
+	 * @throw std::out_of_range, если вершина вне графа
+	 * @throw std::domain_error, если встречено ребро с отрицательным весом
+	 */
+	template <typename Weight, typename Potential = ZeroPotential<Weight>,
+		typename EdgeWeight = GraphEdgeWeight<Weight>>
+	std::optional<typename ShortestPathTree<Weight>::RouteInfo> FindShortestPath(
+		const DirectedWeightedGraph<Weight>& graph, VertexId from, VertexId to,
+		const Potential& potential = {}, SearchCounters* counters = nullptr,
+		const EdgeWeight& edge_weight = {}, size_t max_settled = std::numeric_limits<size_t>::max());
+
+	// ====================================================
+	// Реализация методов
+	// ====================================================
+
+	template <typename Weight>
+	ShortestPathTree<Weight>::ShortestPathTree(const Graph& graph, VertexId source,
+		std::optional<Weight> max_weight)
+		: graph_(graph)
+		, source_(source)
+		, weights_(graph.GetVertexCount())
+		, prev_edge_(graph.GetVertexCount())
+	{
+		if (source >= graph.GetVertexCount()) {
+			throw std::out_of_range("Source vertex is out of range");
+		}
+		Run(max_weight);
+	}
+
+	/**
+	 * Классический алгоритм Дейкстры на бинарной куче с "ленивым" удалением:
+	 * устаревшие элементы очереди пропускаются при извлечении.
+	 */
+	template <typename Weight>
+	void ShortestPathTree<Weight>::Run(std::optional<Weight> max_weight) {
+		std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>> queue;
+		std::vector<bool> settled(graph_.GetVertexCount(), false);
+
+		weights_[source_] = ZERO_WEIGHT;
+		queue.push({ ZERO_WEIGHT, source_ });
+		++counters_.heap_pushes;
+
+		while (!queue.empty()) {
+			const auto [weight, vertex] = queue.top();
+			queue.pop();
+			++counters_.heap_pops;
+
+			if (settled[vertex]) {
+				continue;  // Устаревшая запись
+			}
+			settled[vertex] = true;
+			settled_.push_back(vertex);
+
+			for (const EdgeId edge_id : graph_.GetIncidentEdges(vertex)) {
+				const auto& edge = graph_.GetEdge(edge_id);
+				++counters_.relaxed;
+				if (edge.weight < ZERO_WEIGHT) {
+					throw std::domain_error("Edges' weights should be non-negative");
+				}
+
+				const Weight candidate = weight + edge.weight;
+				if (max_weight && *max_weight < candidate) {
+					continue;  // За пределами порога — не раскрываем
+				}
+
+				auto& best = weights_[edge.to];
+				if (!best || candidate < *best) {
+					best = candidate;
+					prev_edge_[edge.to] = edge_id;
+					queue.push({ candidate, edge.to });
+					++counters_.heap_pushes;
+				}
+			}
+		}
+		counters_.settled = settled_.size();
+	}
+
+	template <typename Weight>
+	VertexId ShortestPathTree<Weight>::GetSource() const {
+		return source_;
+	}
+
+	template <typename Weight>
+	std::optional<Weight> ShortestPathTree<Weight>::GetWeight(VertexId to) const {
+		return weights_.at(to);
+	}
+
+	template <typename Weight>
+	std::optional<EdgeId> ShortestPathTree<Weight>::GetPrevEdge(VertexId to) const {
+		return prev_edge_.at(to);
+	}
+
+	/**
+	 * Собирает рёбра, идя по prev_edge от конечной вершины к начальной.
+	 */
+	template <typename Weight>
+	std::optional<typename ShortestPathTree<Weight>::RouteInfo>
+		ShortestPathTree<Weight>::BuildRoute(VertexId to) const {
+		const auto& weight = weights_.at(to);
+		if (!weight) {
+			return std::nullopt;  // Путь не существует
+		}
+
+		std::vector<EdgeId> edges;
+		for (std::optional<EdgeId> edge_id = prev_edge_[to];
+			edge_id;
+			edge_id = prev_edge_[graph_.GetEdge(*edge_id).from]) {
+			edges.push_back(*edge_id);
+		}
+
+		// Рёбра собраны в обратном порядке — разворачиваем
+		std::reverse(edges.begin(), edges.end());
+
+		return RouteInfo{ *weight, std::move(edges) };
+	}
+
+	template <typename Weight>
+	const std::vector<VertexId>& ShortestPathTree<Weight>::GetSettledVertices() const {
+		return settled_;
+	}
+
+	template <typename Weight>
+	const SearchCounters& ShortestPathTree<Weight>::GetCounters() const {
+		return counters_;
+	}
+
+	template <typename Weight, typename Potential, typename EdgeWeight>
+	std::optional<typename ShortestPathTree<Weight>::RouteInfo> FindShortestPath(
+		const DirectedWeightedGraph<Weight>& graph, VertexId from, VertexId to,
+		const Potential& potential, SearchCounters* counters, const EdgeWeight& edge_weight, size_t max_settled) {
+		using QueueItem = std::pair<Weight, VertexId>;  // (вес пути + оценка, вершина)
+		constexpr Weight zero_weight{};
+
+		const size_t vertex_count = graph.GetVertexCount();
+		if (from >= vertex_count || to >= vertex_count) {
+			throw std::out_of_range("Vertex is out of range");
+		}
+
+		std::vector<std::optional<Weight>> weights(vertex_count);
+		std::vector<std::optional<EdgeId>> prev_edge(vertex_count);
+		std::vector<bool> settled(vertex_count, false);
+		std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>> queue;
+		SearchCounters work;  // Локальные счётчики: без обращений к памяти по указателю в цикле
+
+		// Бесконечная оценка — из вершины до цели не добраться
+		auto is_dead_end = [](const Weight& estimate) {
+			if constexpr (std::numeric_limits<Weight>::has_infinity) {
+				return estimate == std::numeric_limits<Weight>::infinity();
+			}
+			else {
+				return false;
+			}
+		};
+
+		const Weight from_estimate = potential(from);
+		if (is_dead_end(from_estimate)) {
+			if (counters) {
+				*counters = work;
+			}
+			return std::nullopt;
+		}
+		weights[from] = zero_weight;
+		queue.push({ from_estimate, from });
+		++work.heap_pushes;
+
+		while (!queue.empty()) {
+			const VertexId vertex = queue.top().second;
+			queue.pop();
+			++work.heap_pops;
+
+			if (settled[vertex]) {
+				continue;  // Устаревшая запись
+			}
+			settled[vertex] = true;
+			++work.settled;
+			if (vertex == to) {
+				break;  // Расстояние до цели окончательно
+			}
+			if (work.settled == max_settled) {
+				break;  // Лимит работы исчерпан — цель не зафиксирована
+			}
+
+			const Weight weight = *weights[vertex];
+			for (const EdgeId edge_id : graph.GetIncidentEdges(vertex)) {
+				const auto& edge = graph.GetEdge(edge_id);
+				++work.relaxed;
+				const Weight edge_cost = edge_weight(edge_id, edge);
+				if (edge_cost < zero_weight) {
+					throw std::domain_error("Edges' weights should be non-negative");
+				}
+
+				const Weight candidate = weight + edge_cost;
+				auto& best = weights[edge.to];
+				if (!best || candidate < *best) {
+					const Weight estimate = potential(edge.to);
+					if (is_dead_end(estimate)) {
+						continue;
+					}
+					best = candidate;
+					prev_edge[edge.to] = edge_id;
+					queue.push({ candidate + estimate, edge.to });
+					++work.heap_pushes;
+				}
+			}
+		}
+
+		if (counters) {
+			*counters = work;
+		}
+		if (!settled[to]) {
+			return std::nullopt;  // Путь не существует
+		}
+
+		std::vector<EdgeId> edges;
+		for (std::optional<EdgeId> edge_id = prev_edge[to];
+			edge_id;
+			edge_id = prev_edge[graph.GetEdge(*edge_id).from]) {
+			edges.push_back(*edge_id);
+		}
+		std::reverse(edges.begin(), edges.end());
+
+		return typename ShortestPathTree<Weight>::RouteInfo{ *weights[to], std::move(edges) };
+	}
+
+}  // namespace graph
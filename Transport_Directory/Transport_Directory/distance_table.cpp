@@ -0,0 +1,77 @@
+#include "distance_table.h"
+
+#include <algorithm>
+
+namespace trans_cat {
+
+	void DistanceTable::Assign(size_t stop_count, std::vector<DistanceEntry> entries) {
+		// Устойчивая сортировка сохраняет порядок повторов: последний из них — действующий
+		std::stable_sort(entries.begin(), entries.end(), [](const DistanceEntry& lhs, const DistanceEntry& rhs) {
+			return lhs.from != rhs.from ? lhs.from < rhs.from : lhs.to < rhs.to;
+		});
+
+		offsets_.assign(stop_count + 1, 0);
+		neighbors_.clear();
+		neighbors_.reserve(entries.size());
+		pending_.clear();
+
+		for (size_t i = 0; i < entries.size(); ++i) {
+			const DistanceEntry& entry = entries[i];
+			if (i + 1 < entries.size() && entries[i + 1].from == entry.from && entries[i + 1].to == entry.to) {
+				continue;
+			}
+			neighbors_.push_back(Neighbor{ entry.to, entry.meters });
+			++offsets_[entry.from + 1];
+		}
+		for (size_t stop = 0; stop < stop_count; ++stop) {
+			offsets_[stop + 1] += offsets_[stop];
+		}
+	}
+
+	void DistanceTable::Set(uint32_t from, uint32_t to, int meters) {
+		pending_[Key(from, to)] = meters;
+	}
+
+	void DistanceTable::Compact(size_t stop_count) {
+		if (pending_.empty() && offsets_.size() == stop_count + 1) {
+			return;
+		}
+
+		// Сначала записи массива, затем изменения — при повторе пары Assign оставит изменение
+		std::vector<DistanceEntry> entries;
+		entries.reserve(neighbors_.size() + pending_.size());
+		for (uint32_t from = 0; from + 1 < offsets_.size(); ++from) {
+			for (uint32_t i = offsets_[from]; i < offsets_[from + 1]; ++i) {
+				entries.push_back(DistanceEntry{ from, neighbors_[i].to, neighbors_[i].meters });
+			}
+		}
+		for (const auto& [key, meters] : pending_) {
+			entries.push_back(DistanceEntry{ static_cast<uint32_t>(key >> 32), static_cast<uint32_t>(key), meters });
+		}
+		Assign(stop_count, std::move(entries));
+	}
+
+	void DistanceTable::Clear() {
+		offsets_.clear();
+		neighbors_.clear();
+		pending_.clear();
+	}
+
+	size_t DistanceTable::GetSize() const {
+		size_t size = neighbors_.size();
+		for (const auto& [key, meters] : pending_) {
+			const uint32_t from = static_cast<uint32_t>(key >> 32);
+			const uint32_t to = static_cast<uint32_t>(key);
+			const bool in_array = static_cast<size_t>(from) + 1 < offsets_.size()
+				&& std::any_of(neighbors_.begin() + offsets_[from], neighbors_.begin() + offsets_[from + 1],
+					[to](const Neighbor& neighbor) { return neighbor.to == to; });
+			size += !in_array;
+		}
+		return size;
+	}
+
+	size_t DistanceTable::GetMemoryUsage() const {
+		return offsets_.capacity() * sizeof(uint32_t) + neighbors_.capacity() * sizeof(Neighbor);
+	}
+
+} // namespace trans_cat
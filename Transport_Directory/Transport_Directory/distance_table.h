@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace trans_cat {
+
+	/// Дорожное расстояние from → to между остановками с номерами Stop::id
+	struct DistanceEntry {
+		uint32_t from = 0;
+		uint32_t to = 0;
+		int meters = 0;
+	};
+
+	/**
+	 * @brief Дорожные расстояния, сгруппированные по начальной остановке (CSR).
+	 *
+	 * Расстояния задаются только между соседними остановками маршрутов, поэтому
+	 * у остановки их единицы. Соседи всех остановок лежат в одном массиве,
+	 * упорядоченные по (начальная, конечная); offsets_ даёт начало списка
+	 * остановки. Запись — 8 байт: список типичной остановки занимает одну
+	 * строку кэша, и поиск в нём — короткий линейный просмотр без хэширования.
+	 *
+	 * Изменения после построения (Set) копятся в небольшом словаре и имеют
+	 * приоритет над массивом; Compact переносит их в массив.
+	 */
+	class DistanceTable {
+	public:
+		/**
+		 * @brief Строит таблицу заново из списка расстояний.
+		 * @param stop_count Число остановок (номера в entries меньше него)
+		 * @param entries Расстояния; при повторе пары действует последнее
+		 */
+		void Assign(size_t stop_count, std::vector<DistanceEntry> entries);
+
+		/// Задаёт (или меняет) расстояние from → to
+		void Set(uint32_t from, uint32_t to, int meters);
+
+		/// Расстояние from → to, если оно задано (обратное направление не проверяется)
+		std::optional<int> Find(uint32_t from, uint32_t to) const {
+			if (!pending_.empty()) {
+				if (auto it = pending_.find(Key(from, to)); it != pending_.end()) {
+					return it->second;
+				}
+			}
+			if (static_cast<size_t>(from) + 1 >= offsets_.size()) {
+				return std::nullopt;
+			}
+			const Neighbor* first = neighbors_.data() + offsets_[from];
+			const Neighbor* last = neighbors_.data() + offsets_[from + 1];
+			for (; first != last; ++first) {
+				if (first->to == to) {
+					return first->meters;
+				}
+			}
+			return std::nullopt;
+		}
+
+		/// Переносит изменения, накопленные через Set, в основной массив
+		void Compact(size_t stop_count);
+
+		/// Удаляет все расстояния
+		void Clear();
+
+		/// Число заданных пар
+		size_t GetSize() const;
+
+		/// Объём памяти таблицы, байт (без узлов словаря изменений)
+		size_t GetMemoryUsage() const;
+
+	private:
+		struct Neighbor {
+			uint32_t to;
+			int32_t meters;
+		};
+
+		static uint64_t Key(uint32_t from, uint32_t to) {
+			return (uint64_t{ from } << 32) | to;
+		}
+
+		std::vector<uint32_t> offsets_;   ///< Начало списка остановки в neighbors_ (+ конец последнего)
+		std::vector<Neighbor> neighbors_; ///< Соседи, упорядоченные по (начальная, конечная)
+		std::unordered_map<uint64_t, int> pending_;  ///< Изменения после Assign/Compact
+	};
+
+} // namespace trans_cat
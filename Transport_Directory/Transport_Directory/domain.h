@@ -1,7 +1,8 @@
 #pragma once
 
 #include "geo.h"
-#include <string>
+#include <cstdint>
+#include <string_view>
 #include <vector>
 
 
@@ -26,8 +27,10 @@ namespace trans_cat {
      * Используется как элемент маршрутов (Route) и как узел в системе расстояний.
      */
     struct Stop {
-        std::string name;               ///< Название остановки (уникальное в рамках системы)
+        std::string_view name;          ///< Название остановки (уникальное; хранится в арене каталога)
         geo::Coordinates coordinates;   ///< Широта и долгота остановки
+        geo::UnitVector position;       ///< Те же координаты на единичной сфере (для расстояний)
+        uint32_t id = 0;                ///< Номер остановки в каталоге (по порядку добавления)
 
         /**
          * @brief Сравнивает две остановки по имени.
@@ -47,7 +50,7 @@ namespace trans_cat {
      * Может быть кольцевым (is_roundtrip = true) или линейным (с обратным путём).
      */
     struct Route {
-        std::string name;               ///< Уникальное название маршрута
+        std::string_view name;          ///< Уникальное название маршрута (хранится в арене каталога)
         std::vector<const Stop*> stops; ///< Остановки маршрута (указатели)
         bool is_roundtrip = false;      ///< Является ли маршрут кольцевым
 
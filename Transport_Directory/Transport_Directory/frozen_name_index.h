@@ -0,0 +1,145 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace trans_cat {
+
+	/**
+	 * @brief Неизменяемый индекс "имя → объект" для замороженного каталога.
+	 *
+	 * Открытая адресация с линейным пробированием в одном массиве слотов
+	 * (хэш имени, имя, указатель на объект). Ёмкость — степень двойки не меньше
+	 * удвоенного числа имён, поэтому цепочки короткие, а промах заканчивается
+	 * на первом пустом слоте. Полный хэш хранится в слоте: строки сравниваются
+	 * только при совпадении хэша.
+	 *
+	 * В отличие от std::unordered_map — ни узлов, ни бакетов: поиск касается
+	 * одной-двух соседних строк кэша и символов самого имени; объект не читается.
+	 *
+	 * @tparam Object Тип с полем name (Stop, Route); объекты должны пережить индекс
+	 */
+	template <typename Object>
+	class FrozenNameIndex {
+	public:
+		FrozenNameIndex() = default;
+
+		/// Строит индекс по содержимому словаря "имя → объект"
+		explicit FrozenNameIndex(const std::unordered_map<std::string_view, const Object*>& objects);
+
+		/// Объект с именем name или nullptr
+		const Object* Find(std::string_view name) const;
+
+		/// Число имён в индексе
+		size_t GetSize() const {
+			return size_;
+		}
+
+		/// Объём памяти под слоты, байт
+		size_t GetMemoryUsage() const {
+			return slots_.capacity() * sizeof(Slot);
+		}
+
+		/// Хэш имени: 8 байт за шаг, перемешивание в конце (как fmix64 из MurmurHash3)
+		static uint64_t Hash(std::string_view name);
+
+	private:
+		struct Slot {
+			uint64_t hash = 0;
+			std::string_view name;           ///< Копия ключа: сравнение без обращения к объекту
+			const Object* object = nullptr;  ///< nullptr — слот свободен
+		};
+
+		std::vector<Slot> slots_;
+		size_t mask_ = 0;
+		size_t size_ = 0;
+	};
+
+	// ====================================================
+	// Реализация методов
+	// ====================================================
+
+	template <typename Object>
+	FrozenNameIndex<Object>::FrozenNameIndex(const std::unordered_map<std::string_view, const Object*>& objects)
+		: slots_(std::bit_ceil(std::max<size_t>(2 * objects.size(), 2)))
+		, mask_(slots_.size() - 1)
+		, size_(objects.size())
+	{
+		for (const auto& [name, object] : objects) {
+			const uint64_t hash = Hash(name);
+			size_t index = hash & mask_;
+			while (slots_[index].object) {
+				index = (index + 1) & mask_;
+			}
+			slots_[index] = Slot{ hash, name, object };
+		}
+	}
+
+	template <typename Object>
+	const Object* FrozenNameIndex<Object>::Find(std::string_view name) const {
+		if (size_ == 0) {
+			return nullptr;
+		}
+		const uint64_t hash = Hash(name);
+		for (size_t index = hash & mask_; slots_[index].object; index = (index + 1) & mask_) {
+			if (slots_[index].hash == hash && slots_[index].name == name) {
+				return slots_[index].object;
+			}
+		}
+		return nullptr;
+	}
+
+	/**
+	 * Все чтения — фиксированного размера (без вызова memcpy переменной длины):
+	 * хвост длинной строки читается последними 8 байтами с перекрытием,
+	 * короткая строка — двумя 4-байтовыми словами или тремя байтами.
+	 */
+	template <typename Object>
+	uint64_t FrozenNameIndex<Object>::Hash(std::string_view name) {
+		constexpr uint64_t MULTIPLIER = 0x9e3779b97f4a7c15ull;
+		const char* data = name.data();
+		const size_t size = name.size();
+
+		auto load64 = [](const char* p) {
+			uint64_t value;
+			std::memcpy(&value, p, sizeof(value));
+			return value;
+		};
+		auto load32 = [](const char* p) {
+			uint32_t value;
+			std::memcpy(&value, p, sizeof(value));
+			return uint64_t{ value };
+		};
+		auto mix = [](uint64_t hash, uint64_t chunk) {
+			return std::rotl((hash ^ chunk) * MULTIPLIER, 29);
+		};
+
+		uint64_t hash = size * MULTIPLIER;
+		if (size >= 8) {
+			for (size_t pos = 0; pos + 8 < size; pos += 8) {
+				hash = mix(hash, load64(data + pos));
+			}
+			hash = mix(hash, load64(data + size - 8));
+		}
+		else if (size >= 4) {
+			hash = mix(hash, (load32(data) << 32) | load32(data + size - 4));
+		}
+		else if (size > 0) {
+			const auto byte = [data](size_t i) { return uint64_t{ static_cast<unsigned char>(data[i]) }; };
+			hash = mix(hash, (byte(0) << 16) | (byte(size / 2) << 8) | byte(size - 1));
+		}
+
+		hash ^= hash >> 33;
+		hash *= 0xff51afd7ed558ccdull;
+		hash ^= hash >> 33;
+		hash *= 0xc4ceb9fe1a85ec53ull;
+		hash ^= hash >> 33;
+		return hash;
+	}
+
+} // namespace trans_cat
@@ -1,6 +1,7 @@
 #define _USE_MATH_DEFINES
 #include "geo.h"
 
+#include <algorithm>
 #include <cmath>
 
 namespace geo {
@@ -13,4 +14,57 @@ namespace geo {
             * cos(abs(from.lng - to.lng) * DEG_TO_RAD))
             * EARTH_RADIUS_METERS;
     }
+
+    UnitVector ToUnitVector(Coordinates coords) {
+        const double lat = coords.lat * DEG_TO_RAD;
+        const double lng = coords.lng * DEG_TO_RAD;
+        const double cos_lat = std::cos(lat);
+
+        return UnitVector{ cos_lat * std::cos(lng), cos_lat * std::sin(lng), std::sin(lat) };
+    }
+
+    // Угол между единичными векторами; clamp защищает acos от выхода за [-1, 1] из-за округления
+    static double AngleBetween(double dot) {
+        return std::acos(std::clamp(dot, -1.0, 1.0));
+    }
+
+    double ComputeDistance(const UnitVector& from, const UnitVector& to) {
+        return AngleBetween(from.x * to.x + from.y * to.y + from.z * to.z) * EARTH_RADIUS_METERS;
+    }
+
+    // Скалярные произведения соседних точек begin..begin+length; итерации независимы
+    static void ComputeDots(const PathCoordinates& path, size_t begin, size_t length, double* dots) {
+        const double* x = path.x.data() + begin;
+        const double* y = path.y.data() + begin;
+        const double* z = path.z.data() + begin;
+        for (size_t i = 0; i < length; ++i) {
+            dots[i] = x[i] * x[i + 1] + y[i] * y[i + 1] + z[i] * z[i + 1];
+        }
+    }
+
+    double ComputePathLength(const PathCoordinates& path) {
+        const size_t segments = path.Size() < 2 ? 0 : path.Size() - 1;
+
+        // Блок помещается в L1 и не требует памяти в куче
+        constexpr size_t BLOCK_SIZE = 64;
+        double dots[BLOCK_SIZE];
+
+        double angle_sum = 0.0;
+        size_t begin = 0;
+
+        // Полные блоки — с постоянным числом итераций: такой цикл векторизуется уже на -O2
+        for (; begin + BLOCK_SIZE <= segments; begin += BLOCK_SIZE) {
+            ComputeDots(path, begin, BLOCK_SIZE, dots);
+            for (double dot : dots) {
+                angle_sum += AngleBetween(dot);
+            }
+        }
+
+        const size_t tail = segments - begin;
+        ComputeDots(path, begin, tail, dots);
+        for (size_t i = 0; i < tail; ++i) {
+            angle_sum += AngleBetween(dots[i]);
+        }
+        return angle_sum * EARTH_RADIUS_METERS;
+    }
 }  // namespace geo
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <cstddef>
+#include <vector>
+
 namespace geo {
 
     /**
@@ -10,6 +13,19 @@ namespace geo {
         double lng; // долгота в градусах
     };
 
+    /**
+     * @brief Точка на единичной сфере (декартовы координаты).
+     *
+     * Вычисляется из Coordinates один раз; после этого расстояние по дуге
+     * большого круга сводится к скалярному произведению и одному acos —
+     * без пересчёта sin/cos широты и долготы на каждый вызов.
+     */
+    struct UnitVector {
+        double x = 0.0;
+        double y = 0.0;
+        double z = 0.0;
+    };
+
     // =============================================================================
     // Константы для геометрических вычислений
     // =============================================================================
@@ -63,4 +79,69 @@ namespace geo {
      */
     double ComputeDistance(Coordinates from, Coordinates to);
 
+    /**
+     * @brief Переводит географические координаты в точку на единичной сфере.
+     */
+    UnitVector ToUnitVector(Coordinates coords);
+
+    /**
+     * @brief Вычисляет расстояние между двумя точками на сфере по их единичным векторам.
+     *
+     * Совпадает с ComputeDistance(Coordinates, Coordinates) в пределах погрешности
+     * вычислений с плавающей точкой.
+     *
+     * @return Расстояние в метрах
+     */
+    double ComputeDistance(const UnitVector& from, const UnitVector& to);
+
+    /**
+     * @brief Точки ломаной на единичной сфере в виде структуры массивов (SoA).
+     *
+     * i-я точка — (x[i], y[i], z[i]). Каждая координата лежит в своём непрерывном
+     * массиве, поэтому скалярные произведения соседних точек считаются
+     * векторными инструкциями. Буфер рассчитан на повторное использование:
+     * Clear() сохраняет выделенную память.
+     */
+    struct PathCoordinates {
+        std::vector<double> x;
+        std::vector<double> y;
+        std::vector<double> z;
+
+        void Clear() {
+            x.clear();
+            y.clear();
+            z.clear();
+        }
+
+        void Reserve(size_t count) {
+            x.reserve(count);
+            y.reserve(count);
+            z.reserve(count);
+        }
+
+        void Add(const UnitVector& point) {
+            x.push_back(point.x);
+            y.push_back(point.y);
+            z.push_back(point.z);
+        }
+
+        size_t Size() const {
+            return x.size();
+        }
+    };
+
+    /**
+     * @brief Вычисляет длину ломаной, проходящей через точки path по порядку.
+     *
+     * Пакетный вариант ComputeDistance. Отрезки обрабатываются блоками: скалярные
+     * произведения блока считаются по массивам SoA в буфер на стеке (этот цикл
+     * компилятор векторизует), затем углы блока накапливаются в сумму.
+     * acos остаётся скалярным — векторной реализации без -ffast-math и
+     * библиотеки векторной математики компилятор не подставляет.
+     * Память в куче не выделяется.
+     *
+     * @return Сумма расстояний между соседними точками в метрах (0 для менее чем двух точек)
+     */
+    double ComputePathLength(const PathCoordinates& path);
+
 } // namespace geo
@@ -2,6 +2,7 @@
 
 #include "ranges.h"
 
+#include <algorithm>
 #include <cstdlib>
 #include <vector>
 
@@ -81,6 +82,37 @@ namespace graph {
 		 */
 		EdgeId AddEdge(const Edge<Weight>& edge);
 
+		/**
+		 * @brief Резервирует место под общее число рёбер (как vector::reserve).
+		 * @param edge_count Ожидаемое число рёбер в графе
+		 */
+		void ReserveEdges(size_t edge_count);
+
+		/**
+		 * @brief Добавляет в граф новую вершину (без рёбер).
+		 * @return Идентификатор добавленной вершины
+		 * @note Сложность: O(1) амортизированно
+		 */
+		VertexId AddVertex();
+
+		/**
+		 * @brief Изменяет вес существующего ребра.
+		 * @param edge_id Идентификатор ребра
+		 * @param weight Новый вес
+		 * @note Сложность: O(1)
+		 */
+		void SetEdgeWeight(EdgeId edge_id, Weight weight);
+
+		/**
+		 * @brief Исключает ребро из графа.
+		 *
+		 * Ребро удаляется из списка исходящих рёбер своей вершины, но его ID
+		 * остаётся занятым: идентификаторы остальных рёбер не меняются.
+		 * @param edge_id Идентификатор ребра
+		 * @note Сложность: O(выходная степень вершины edge.from)
+		 */
+		void RemoveEdge(EdgeId edge_id);
+
 		/**
 		 * @brief Возвращает количество вершин в графе.
 		 * @note Сложность: O(1)
@@ -89,6 +121,7 @@ namespace graph {
 
 		/**
 		 * @brief Возвращает количество рёбер в графе.
+		 * @note Учитываются и исключённые рёбра (см. RemoveEdge) — их ID остаются занятыми.
 		 * @note Сложность: O(1)
 		 */
 		size_t GetEdgeCount() const;
@@ -139,6 +172,29 @@ namespace graph {
 		return id;
 	}
 
+	template <typename Weight>
+	void DirectedWeightedGraph<Weight>::ReserveEdges(size_t edge_count) {
+		edges_.reserve(edge_count);
+	}
+
+	template <typename Weight>
+	VertexId DirectedWeightedGraph<Weight>::AddVertex() {
+		incidence_lists_.emplace_back();
+		return incidence_lists_.size() - 1;
+	}
+
+	template <typename Weight>
+	void DirectedWeightedGraph<Weight>::SetEdgeWeight(EdgeId edge_id, Weight weight) {
+		edges_.at(edge_id).weight = weight;
+	}
+
+	template <typename Weight>
+	void DirectedWeightedGraph<Weight>::RemoveEdge(EdgeId edge_id) {
+		auto& incidence_list = incidence_lists_.at(edges_.at(edge_id).from);
+		incidence_list.erase(std::remove(incidence_list.begin(), incidence_list.end(), edge_id),
+			incidence_list.end());
+	}
+
 	template <typename Weight>
 	size_t DirectedWeightedGraph<Weight>::GetVertexCount() const {
 		return incidence_lists_.size();
@@ -0,0 +1,199 @@
+#include "input_buffer.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace input_buffer {
+
+#ifndef _WIN32
+    namespace {
+
+        constexpr size_t READ_BLOCK = 1 << 20;  ///< Размер блока read() для каналов
+
+        std::runtime_error SystemError(const std::string& what) {
+            return std::runtime_error(what + ": " + std::strerror(errno));
+        }
+
+        /// Закрывает дескриптор при выходе из области видимости (кроме стандартного ввода)
+        class FileCloser {
+        public:
+            explicit FileCloser(int fd) : fd_(fd) {}
+            FileCloser(const FileCloser&) = delete;
+            FileCloser& operator=(const FileCloser&) = delete;
+            ~FileCloser() {
+                if (fd_ > STDERR_FILENO) {
+                    ::close(fd_);
+                }
+            }
+
+        private:
+            int fd_;
+        };
+
+        /**
+         * @brief Отображает обычный файл целиком в память.
+         * @return Начало отображения или nullptr, если файл не отображается (тогда его читают read())
+         */
+        const char* MapFile(int fd, size_t size) {
+            // Подсказка ядру: читать с упреждением большими порциями
+            ::posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+            int flags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+            flags |= MAP_POPULATE;  // Страницы загружаются сразу, без отказов страниц во время разбора
+#endif
+            void* data = ::mmap(nullptr, size, PROT_READ, flags, fd, 0);
+            if (data == MAP_FAILED) {
+                return nullptr;
+            }
+            ::madvise(data, size, MADV_SEQUENTIAL);
+#ifdef MADV_HUGEPAGE
+            // Большие страницы для отображения файла — только если их поддерживает файловая система; иначе не действует
+            ::madvise(data, size, MADV_HUGEPAGE);
+#endif
+            return static_cast<const char*>(data);
+        }
+
+        /// Читает дескриптор до конца блоками READ_BLOCK
+        std::string ReadAll(int fd, size_t size_hint) {
+            std::string data;
+            data.resize(std::max(size_hint, READ_BLOCK));
+            size_t size = 0;
+            while (true) {
+                if (data.size() - size < READ_BLOCK) {
+                    data.resize(data.size() * 2);
+                }
+                const ssize_t count = ::read(fd, data.data() + size, data.size() - size);
+                if (count == 0) {
+                    break;
+                }
+                if (count < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    throw SystemError("Cannot read input");
+                }
+                size += static_cast<size_t>(count);
+            }
+            data.resize(size);
+            return data;
+        }
+
+    } // namespace
+#endif
+
+    InputBuffer InputBuffer::FromFile(const std::string& path) {
+        InputBuffer buffer;
+#ifdef _WIN32
+        std::ifstream input(path, std::ios::binary);
+        if (!input) {
+            throw std::runtime_error("Cannot open " + path);
+        }
+        std::ostringstream text;
+        text << input.rdbuf();
+        buffer.data_ = std::move(text).str();
+#else
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            throw SystemError("Cannot open " + path);
+        }
+        FileCloser closer(fd);
+
+        struct stat info {};
+        if (::fstat(fd, &info) == 0 && S_ISREG(info.st_mode)) {
+            if (info.st_size == 0) {
+                return buffer;
+            }
+            // Отображение остаётся действительным и после закрытия дескриптора
+            const auto size = static_cast<size_t>(info.st_size);
+            if (const char* data = MapFile(fd, size)) {
+                buffer.mapped_ = data;
+                buffer.mapped_size_ = size;
+                return buffer;
+            }
+            buffer.data_ = ReadAll(fd, size + 1);
+            return buffer;
+        }
+        buffer.data_ = ReadAll(fd, 0);
+#endif
+        return buffer;
+    }
+
+    InputBuffer InputBuffer::FromStdin() {
+        InputBuffer buffer;
+#ifdef _WIN32
+        std::ostringstream text;
+        if (std::cin.peek() != EOF) {
+            text << std::cin.rdbuf();
+        }
+        buffer.data_ = std::move(text).str();
+#else
+        // Ввод, перенаправленный из файла и ещё не прочитанный, отображается как файл
+        struct stat info {};
+        if (::fstat(STDIN_FILENO, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0
+            && ::lseek(STDIN_FILENO, 0, SEEK_CUR) == 0) {
+            const auto size = static_cast<size_t>(info.st_size);
+            if (const char* data = MapFile(STDIN_FILENO, size)) {
+                buffer.mapped_ = data;
+                buffer.mapped_size_ = size;
+                return buffer;
+            }
+        }
+        buffer.data_ = ReadAll(STDIN_FILENO, 0);
+#endif
+        return buffer;
+    }
+
+    InputBuffer::InputBuffer(InputBuffer&& other) noexcept
+        : mapped_(std::exchange(other.mapped_, nullptr))
+        , mapped_size_(std::exchange(other.mapped_size_, 0))
+        , data_(std::move(other.data_)) {
+    }
+
+    InputBuffer& InputBuffer::operator=(InputBuffer&& other) noexcept {
+        if (this != &other) {
+            Unmap();
+            mapped_ = std::exchange(other.mapped_, nullptr);
+            mapped_size_ = std::exchange(other.mapped_size_, 0);
+            data_ = std::move(other.data_);
+        }
+        return *this;
+    }
+
+    InputBuffer::~InputBuffer() {
+        Unmap();
+    }
+
+    std::string_view InputBuffer::GetView() const {
+        return mapped_ ? std::string_view(mapped_, mapped_size_) : std::string_view(data_);
+    }
+
+    bool InputBuffer::IsMapped() const {
+        return mapped_ != nullptr;
+    }
+
+    void InputBuffer::Unmap() noexcept {
+#ifndef _WIN32
+        if (mapped_) {
+            ::munmap(const_cast<char*>(mapped_), mapped_size_);
+        }
+#endif
+        mapped_ = nullptr;
+        mapped_size_ = 0;
+    }
+
+} // namespace input_buffer
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief Модуль чтения входных данных целиком в непрерывный буфер.
+ *
+ * Обычный файл отображается в память (mmap) с подсказками ядру о
+ * последовательном чтении (posix_fadvise, madvise) и предзагрузкой страниц,
+ * поэтому текст разбирается со скоростью диска/страничного кэша, без
+ * копирования через iostream. Так же отображается стандартный ввод,
+ * перенаправленный из файла. Канал и прочие источники читаются read()
+ * блоками по 1 МБ в буфер, растущий вдвое.
+ */
+namespace input_buffer {
+
+    /**
+     * @brief Входные данные целиком: отображение файла в память или прочитанный буфер.
+     *
+     * Только перемещается; отображение снимается в деструкторе.
+     *
+     * @example
+     * const auto input = input_buffer::InputBuffer::FromFile("city.json");
+     * json::Document doc = json::Load(input.GetView());
+     */
+    class InputBuffer {
+    public:
+        /**
+         * @brief Читает файл path (обычный файл отображается в память).
+         * @throw std::runtime_error, если файл не открывается или не читается
+         */
+        static InputBuffer FromFile(const std::string& path);
+
+        /**
+         * @brief Читает стандартный ввод до конца (перенаправленный файл отображается в память).
+         * @throw std::runtime_error при ошибке чтения
+         */
+        static InputBuffer FromStdin();
+
+        InputBuffer(InputBuffer&& other) noexcept;
+        InputBuffer& operator=(InputBuffer&& other) noexcept;
+        InputBuffer(const InputBuffer&) = delete;
+        InputBuffer& operator=(const InputBuffer&) = delete;
+        ~InputBuffer();
+
+        /// Текст входных данных; действителен, пока жив буфер
+        std::string_view GetView() const;
+
+        /// Данные отображены в память (а не прочитаны в буфер)
+        bool IsMapped() const;
+
+    private:
+        InputBuffer() = default;
+
+        void Unmap() noexcept;
+
+        const char* mapped_ = nullptr;  ///< Начало отображения (nullptr — данные в data_)
+        size_t mapped_size_ = 0;
+        std::string data_;              ///< Прочитанные данные, если отображения нет
+    };
+
+} // namespace input_buffer
@@ -2,57 +2,10 @@
 
 #include <algorithm>
 #include <cassert>
-#include <iterator>
+#include <utility>
 #include <iostream>
 #include "stat_reader.h"
 
-/*
- * Разбирает строку `str` на составляющие части, используя регулярные выражения.
- * Извлекает географические координаты и информацию о расстояниях до соседних остановок.
- * Возвращает структуру `StopData`, содержащую:
- * - координаты (`coordinates`);
- * - контейнер с названиями соседних остановок и расстояниями до них (`nearby_stops`).
- *
- * @param str Строка с данными об остановке
- * @return Структура `StopData` с разложенными данными
- * @throws std::invalid_argument Если формат данных некорректен или координаты не могут быть преобразованы
- */
-StopData ParseStopData(std::string str) {
-	StopData stop_data;
-	std::smatch coords_match;
-
-	// Выделение географических координат
-	if (!std::regex_match(str, coords_match, InputReader::coords_regex)) {
-		throw std::invalid_argument("Invalid stop data format");
-	}
-
-	// Попытка получения географических координат
-	try {
-		stop_data.coordinates.lat = std::stod(std::string(coords_match[1].str()));
-		stop_data.coordinates.lng = std::stod(std::string(coords_match[2].str()));
-	}
-	catch (...) {
-		throw std::invalid_argument("Invalid coordinates in stop data");
-	}
-
-	// Остаток строки - набор расстояний и наименований соседних остановок
-	std::string remaining_string(coords_match[3].str());
-
-	// Итераторы - бегунок и конец строки
-	std::sregex_iterator it(remaining_string.begin(), remaining_string.end(), InputReader::distance_regex);
-	std::sregex_iterator end;
-
-	// Парсинг соседних остановок
-	for (; it != end; ++it) {
-		std::smatch match = *it;
-		int distance = std::stoi(match[1].str());
-		std::string name(match[2].str());
-		stop_data.nearby_stops.emplace(std::move(name), distance);
-	}
-
-	return stop_data;
-}
-
 /*
  * Удаляет пробелы в начале и конце строки
  */
@@ -85,49 +38,24 @@ std::vector<std::string_view> Split(std::string_view string, char delim) {
 	return result;
 }
 
+// Остановки маршрута в прямом направлении и признак кольцевого маршрута
+struct RouteDescription {
+	std::vector<std::string> stops;
+	bool is_roundtrip = false;
+};
+
 /*
  * Парсит маршрут.
- * Для кольцевого маршрута (A>B>C>A) возвращает массив названий остановок [A,B,C,A]
- * Для некольцевого маршрута (A-B-C-D) возвращает массив названий остановок [A,B,C,D,C,B,A]
+ * Кольцевой маршрут (A>B>C>A): остановки [A,B,C,A], is_roundtrip = true
+ * Некольцевой маршрут (A-B-C-D): остановки [A,B,C,D], is_roundtrip = false
+ * (обратный путь достраивает каталог, как и для маршрутов из JSON)
  */
-std::vector<std::string_view> ParseRoute(std::string_view route) {
-	if (route.find('>') != route.npos) {
-		return Split(route, '>');
-	}
+RouteDescription ParseRoute(std::string_view route) {
+	RouteDescription result;
+	result.is_roundtrip = route.find('>') != route.npos;
 
-	auto stops = Split(route, '-');
-	std::vector<std::string_view> results(stops.begin(), stops.end());
-	results.insert(results.end(), std::next(stops.rbegin()), stops.rend());
-
-	return results;
-}
-
-/*
- * Разбирает строку `line` на составляющие части, используя регулярные выражения.
- * Находит соответствие между строкой и заранее определёнными шаблонами команд.
- * Возвращает структуру `CommandDescription`, содержащую:
- * - название команды (`command`);
- * - идентификатор (`id`);
- * - описание параметров (`description`).
- *
- * @param line Строка с описанием команды
- * @return Структура `CommandDescription` с разложенными данными
- */
-CommandDescription ParseCommandDescription(std::string_view line) {
-	CommandDescription result{};
-	std::smatch match;
-
-	// Преобразуем string_view в string
-	std::string line_str(line);
-
-	for (const auto& cmd_reg : InputReader::cmd_regs) {
-		if (std::regex_match(line_str, match, cmd_reg.first)) {
-			result.command = cmd_reg.second;
-			result.id = match[1].str();
-			result.description = match[2].str();
-			break;
-		}
-	}
+	const auto stops = Split(route, result.is_roundtrip ? '>' : '-');
+	result.stops.assign(stops.begin(), stops.end());
 
 	return result;
 }
@@ -139,28 +67,31 @@ void InputReader::ParseLine(std::string_view line) {
 	}
 }
 
-void InputReader::ApplyCommands([[maybe_unused]] trans_cat::TransportCatalogue& catalogue) const {
+void InputReader::ApplyCommands(trans_cat::TransportCatalogue& catalogue) const {
 	static const std::string stop_cmd("Stop");
 
+	// Сначала все остановки с координатами: расстояния и маршруты ссылаются на них по имени,
+	// и заглушки создаются только для остановок, не описанных во входе
+	std::vector<std::pair<std::string_view, StopData>> stops;
 	for (auto const& cur : commands_) {
-
-		// Обрабатываем команды типа "Stop"
 		if (cur.command == stop_cmd) {
 			auto stop_data = ParseStopData(cur.description);
-			auto added_stop = catalogue.AddStop(cur.id, stop_data.coordinates);
-			for (const auto& stop : stop_data.nearby_stops) {
-				auto target_stop = catalogue.FindStop(stop.first);
-				if (target_stop == nullptr) {
-					std::string stop_name(stop.first);
-					target_stop = catalogue.AddStop(stop_name, {0,0});
-				}
-				catalogue.SetDistance(added_stop, target_stop, stop.second);
-			}
+			catalogue.AddStop(cur.id, stop_data.coordinates);
+			stops.emplace_back(cur.id, std::move(stop_data));
 		}
-		
-		// Обрабатываем команды типа "Bus"
-		else if (cur.command != stop_cmd) {
-			catalogue.AddRoute(cur.id, ParseRoute(cur.description));
+	}
+
+	for (const auto& [name, stop_data] : stops) {
+		for (const auto& [target_name, distance] : stop_data.nearby_stops) {
+			catalogue.SetDistance(name, target_name, distance);
+		}
+	}
+
+	// Обрабатываем команды типа "Bus"
+	for (auto const& cur : commands_) {
+		if (cur.command != stop_cmd) {
+			const auto route = ParseRoute(cur.description);
+			catalogue.AddRoute(cur.id, route.stops, route.is_roundtrip);
 		}
 	}
 }
@@ -181,9 +112,13 @@ void InputReader::ProcessRequest(std::istream& input, std::ostream& output, tran
 	int stat_request_count;
 	input >> stat_request_count >> std::ws;
 
+	// Ответы пишутся блоками; поток сбрасывается один раз в конце
+	stat_r::StatWriter writer(output);
+	std::string line;
 	for (int i = 0; i < stat_request_count; ++i) {
-		std::string line;
 		std::getline(input, line);
-		stat_r::ParseAndPrintStat(catalogue, line, output);
+		writer.ParseAndPrintStat(catalogue, line);
 	}
+	writer.Flush();
+	output.flush();
 }
@@ -322,17 +322,83 @@ namespace json {
     // =============================================================================
     namespace {
 
+        /**
+         * @brief Посимвольное чтение разбираемого текста из непрерывного буфера.
+         *
+         * Повторяет используемую парсером часть интерфейса std::istream (get, peek,
+         * putback, std::ws, operator>>(char&)) без накладных расходов потока.
+         * Как и поток, запоминает неудачное чтение в конце текста: после него
+         * Unget ничего не возвращает.
+         */
+        class Reader {
+        public:
+            explicit Reader(std::string_view text)
+                : text_(text) {
+            }
+
+            /// Следующий символ без извлечения (как unsigned char) или EOF
+            int Peek() const {
+                return pos_ < text_.size() ? static_cast<unsigned char>(text_[pos_]) : EOF;
+            }
+
+            /// Извлекает символ; false — конец текста
+            bool Get(char& c) {
+                if (pos_ == text_.size()) {
+                    failed_ = true;
+                    return false;
+                }
+                c = text_[pos_++];
+                return true;
+            }
+
+            /// Пропускает пробельные символы и извлекает следующий (как input >> c)
+            bool GetNonSpace(char& c) {
+                SkipSpaces();
+                return Get(c);
+            }
+
+            /// Возвращает последний извлечённый символ (как putback)
+            void Unget() {
+                if (!failed_ && pos_ > 0) {
+                    --pos_;
+                }
+            }
+
+            /// Пропускает пробельные символы (как std::ws)
+            void SkipSpaces() {
+                while (pos_ < text_.size() && std::isspace(static_cast<unsigned char>(text_[pos_]))) {
+                    ++pos_;
+                }
+            }
+
+            /// Извлекает символы до первого из stop_chars или управляющего символа
+            std::string_view TakeUntil(std::string_view stop_chars) {
+                const size_t start = pos_;
+                while (pos_ < text_.size() && static_cast<unsigned char>(text_[pos_]) >= 32
+                    && stop_chars.find(text_[pos_]) == stop_chars.npos) {
+                    ++pos_;
+                }
+                return text_.substr(start, pos_ - start);
+            }
+
+        private:
+            std::string_view text_;
+            size_t pos_ = 0;
+            bool failed_ = false;   ///< Было чтение за концом текста
+        };
+
+
         bool IsDigit(char c);
 
-        char PeekChar(std::istream& input);
-        void CheckLiteral(std::istream& input, std::string_view literal);
-        void ExpectChar(std::istream& input, char expected);
+        char PeekChar(Reader& input);
+        void CheckLiteral(Reader& input, std::string_view literal);
+        void ExpectChar(Reader& input, char expected);
 
-        std::string ParseString(std::istream& input);
-        Node ParseNumber(std::istream& input);
-        Node ParseArray(std::istream& input);
-        Node ParseDict(std::istream& input);
-        Node ParseNode(std::istream& input);
+        std::string ParseString(Reader& input);
+        Node ParseNumber(Reader& input);
+        Node ParseArray(Reader& input);
+        Node ParseDict(Reader& input);
+        Node ParseNode(Reader& input);
 
         /**
          * @brief Проверяет, является ли символ цифрой ('0'–'9').
@@ -356,15 +422,15 @@ namespace json {
          * Пропускает все пробельные символы (используя std::ws), затем смотрит следующий символ.
          * Если поток достиг EOF, выбрасывает ParsingError.
          *
-         * @param input Входной поток
+         * @param input Входной текст
          * @return char Следующий непробельный символ
          * @throws ParsingError Если достигнут конец потока
          *
          * @note Используется как первый шаг при определении типа JSON-значения.
          */
-        char PeekChar(std::istream& input) {
-            std::ws(input);
-            int c = input.peek();
+        char PeekChar(Reader& input) {
+            input.SkipSpaces();
+            int c = input.Peek();
             if (c == EOF) {
                 throw ParsingError("Unexpected end of input");
             }
@@ -379,17 +445,17 @@ namespace json {
          *
          * Используется для распознавания литералов: true, false, null.
          *
-         * @param input Входной поток
+         * @param input Входной текст
          * @param literal Ожидаемая строка (например, "true")
          * @throws ParsingError Если строка не совпадает или поток обрывается
          *
          * @example
          * CheckLiteral(input, "null"); // ожидаем, что дальше идёт "null"
          */
-        void CheckLiteral(std::istream& input, std::string_view literal) {
+        void CheckLiteral(Reader& input, std::string_view literal) {
             for (char expected : literal) {
                 char c;
-                if (!input.get(c) || c != expected) {
+                if (!input.Get(c) || c != expected) {
                     throw ParsingError("Invalid literal: expected '" + std::string(literal) + "'");
                 }
             }
@@ -406,16 +472,16 @@ namespace json {
          * - разделители: , :
          * - начало строк: "
          *
-         * @param input Входной поток
+         * @param input Входной текст
          * @param expected Ожидаемый символ
          * @throws ParsingError Если символ отсутствует или не совпадает
          *
          * @example
          * ExpectChar(input, '{'); // убедится, что текущий токен — начало объекта
          */
-        void ExpectChar(std::istream& input, char expected) {
+        void ExpectChar(Reader& input, char expected) {
             char c;
-            if (!(input >> c) || c != expected) {
+            if (!input.GetNonSpace(c) || c != expected) {
                 throw ParsingError("Expected '" + std::string(1, expected) + "'");
             }
         }
@@ -436,22 +502,23 @@ namespace json {
          *
          * Управляющие символы (кроме разрешённых) недопустимы в JSON.
          *
-         * @param input Входной поток (ожидается, что первый '"' уже прочитан)
+         * @param input Входной текст (ожидается, что первый '"' уже прочитан)
          * @return std::string Распарсенная строка без кавычек и escape-последовательностей
          * @throws ParsingError При незавершённой строке, неизвестном escape-коде или управляющем символе
          *
          * @note Не добавляет в строку символ закрывающей кавычки — он просто завершает чтение.
          */
-        std::string ParseString(std::istream& input) {
+        std::string ParseString(Reader& input) {
             std::string result{};
             char c;
 
-            while (input.get(c)) {
+            // Обычные символы копируются участками, по одному — только кавычка, '\\' и управляющие
+            while (result.append(input.TakeUntil("\"\\")), input.Get(c)) {
                 if (c == '"') {
                     return result;
                 }
                 else if (c == '\\') {
-                    if (!input.get(c)) {
+                    if (!input.Get(c)) {
                         throw ParsingError("Unexpected end of string after '\\'");
                     }
                     switch (c) {
@@ -491,24 +558,24 @@ namespace json {
          * В противном случае — как double.
          * Если целое число выходит за пределы int, оно автоматически интерпретируется как double.
          *
-         * @param input Входной поток
+         * @param input Входной текст
          * @return Node Узел типа int или double
          * @throws ParsingError При неверном формате, отсутствии цифр, переполнении или NaN/inf
          *
          * @note Использует std::stoll и std::stod с проверками на out_of_range и конечность значения.
          */
-        Node ParseNumber(std::istream& input) {
+        Node ParseNumber(Reader& input) {
             std::string num;
             char c;
 
             // Считываем первый символ (пропуская пробелы)
-            if (!(input >> c)) {
+            if (!input.GetNonSpace(c)) {
                 throw ParsingError("Unexpected end of input");
             }
 
             if (c == '-') {
                 num += c;
-                if (!(input >> c)) {
+                if (!input.GetNonSpace(c)) {
                     throw ParsingError("Unexpected end of input");
                 }
             }
@@ -520,48 +587,48 @@ namespace json {
             // Целая часть
             do {
                 num += c;
-                if (!input.get(c)) {
+                if (!input.Get(c)) {
                     break;
                 }
             } while (IsDigit(c)); // Проверяем уже следующий символ
 
             // Возвращаем последний символ, если это не цифра
-            input.putback(c);
+            input.Unget();
 
             // Дробная часть
-            if (input.peek() == '.') {
-                if (!input.get(c)) {
+            if (input.Peek() == '.') {
+                if (!input.Get(c)) {
                     throw ParsingError("Unexpected end of input");
                 }
                 num += c;
 
-                if (!IsDigit(input.peek())) {
+                if (!IsDigit(input.Peek())) {
                     throw ParsingError("Invalid number format: missing digits after '.'");
                 }
 
-                while (IsDigit(input.peek())) {
-                    input.get(c);
+                while (IsDigit(input.Peek())) {
+                    input.Get(c);
                     num += c;
                 }
             }
 
             // Экспонента
-            if (input.peek() == 'e' || input.peek() == 'E') {
-                input.get(c);
+            if (input.Peek() == 'e' || input.Peek() == 'E') {
+                input.Get(c);
                 num += c;
 
                 // Знак экспоненты
-                if (input.peek() == '+' || input.peek() == '-') {
-                    input.get(c);
+                if (input.Peek() == '+' || input.Peek() == '-') {
+                    input.Get(c);
                     num += c;
                 }
 
-                if (!IsDigit(input.peek())) {
+                if (!IsDigit(input.Peek())) {
                     throw ParsingError("Invalid number format: missing digits after exponent");
                 }
 
-                while (IsDigit(input.peek())) {
-                    input.get(c);
+                while (IsDigit(input.Peek())) {
+                    input.Get(c);
                     num += c;
                 }
             }
@@ -600,13 +667,13 @@ namespace json {
          * Элементы разделяются запятыми, пробелы игнорируются.
          * Пустой массив: [] — допустим.
          *
-         * @param input Входной поток
+         * @param input Входной текст
          * @return Node Узел, содержащий Array
          * @throws ParsingError При отсутствии ']', неправильных элементах или отсутствии запятых
          *
          * @note Вызывает ParseNode для каждого элемента (рекурсивно).
          */
-        Node ParseArray(std::istream& input) {
+        Node ParseArray(Reader& input) {
             ExpectChar(input, '[');
 
             Array arr;
@@ -630,14 +697,14 @@ namespace json {
          * Ключ всегда — строка в кавычках.
          * Значение — любой валидный JSON-узел.
          *
-         * @param input Входной поток
+         * @param input Входной текст
          * @return Node Узел, содержащий Dict
          * @throws ParsingError При синтаксических ошибках, дубликатах ключей или отсутствии '}'.
          *
          * @note Дублирование ключей не разрешено — выбрасывается ошибка.
          *       Это строже стандарта, но помогает избежать ошибок.
          */
-        Node ParseDict(std::istream& input) {
+        Node ParseDict(Reader& input) {
             ExpectChar(input, '{');
 
             Dict dict;
@@ -673,13 +740,13 @@ namespace json {
          *
          * Пробелы перед токеном автоматически пропускаются.
          *
-         * @param input Входной поток
+         * @param input Входной текст
          * @return Node Распарсенный узел любого типа
          * @throws ParsingError При неизвестном символе, неполном значении или синтаксической ошибке
          *
          * @note Использует рекурсию для вложенных структур (массивы, объекты).
          */
-        Node ParseNode(std::istream& input) {
+        Node ParseNode(Reader& input) {
             char c = PeekChar(input);
 
             switch (c) {
@@ -710,16 +777,27 @@ namespace json {
 
     } // anonymous namespace
 
+    Document Load(std::string_view text) {
+        Reader input(text);
+        Node root = ParseNode(input);
+        input.SkipSpaces();
+        if (input.Peek() != EOF) {
+            throw ParsingError("Unexpected content after JSON");
+        }
+
+        // Дерево перемещается: копия удваивала время загрузки больших документов
+        return Document(std::move(root));
+    }
+
     Document Load(std::istream& input) {
         try {
-            Node root = ParseNode(input);
-            std::ws(input);
+            // Поток читается целиком: разбор непрерывного буфера быстрее посимвольного чтения потока
+            std::ostringstream text;
             if (input.peek() != EOF) {
-                throw ParsingError("Unexpected content after JSON");
+                text << input.rdbuf();
             }
-
-            // В тренажере не проходит return Document(std::move(root))
-            return Document(root);
+            const std::string buffer = std::move(text).str();
+            return Load(std::string_view(buffer));
         }
         catch (const std::ios_base::failure&) {
             throw ParsingError("IO error");
@@ -2,6 +2,7 @@
 
 #include <iostream>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <map>
 #include <variant>
@@ -217,13 +218,21 @@ namespace json {
     };
 
     /**
-     * @brief Загружает JSON-документ из потока.
+     * @brief Загружает JSON-документ из потока (поток читается до конца).
      * @param input Входной поток
      * @return Document Объект документа
      * @throw ParsingError При синтаксических ошибках
      */
     Document Load(std::istream& input);
 
+    /**
+     * @brief Загружает JSON-документ из непрерывного буфера (например, отображённого в память файла).
+     * @param text Текст документа целиком
+     * @return Document Объект документа
+     * @throw ParsingError При синтаксических ошибках
+     */
+    Document Load(std::string_view text);
+
     /**
      * @brief Выводит документ в поток в формате JSON.
      * @param doc Документ
@@ -1,4 +1,6 @@
 #include "json_reader.h"
+#include "catalogue_builder.h"
+#include "profiler.h"
 #include <stdexcept>
 #include <string>
 
@@ -8,22 +10,37 @@ namespace json_reader {
         : catalogue_(tc) {
     }
 
-    void JSONReader::LoadFromJson(const json::Document& input) {
+    void JSONReader::LoadFromJson(const json::Document& input, Validation validation) {
+        PROFILE_FUNCTION();
+        load_problems_.clear();
 
-        // Читаем root из json'а
-        const json::Dict& root = input.GetRoot().AsDict();
+        // Без остановок не бывает и маршрутов — каталог пуст, грузим пакетно
+        if (!catalogue_.GetAllStops().empty()) {
+            LoadFromJsonIncremental(input);
+            return;
+        }
 
-        // Попытка найти в root узел 'base_requests'
-        auto it = root.find("base_requests");
-        if (it == root.end()) {
-            throw json::ParsingError("Missing 'base_requests' in input");
+        try {
+            LoadBulk(GetBaseRequests(input));
         }
+        catch (const std::invalid_argument& e) {
+            if (validation == Validation::Strict) {
+                throw;
+            }
+            // Builder вернул каталог в пустое состояние — грузим с прежней, нестрогой семантикой
+            load_problems_ = e.what();
+            LoadFromJsonIncremental(input);
+        }
+    }
 
-        // Получение узла (массива)
-        const json::Array& base_requests = it->second.AsArray();
+    const std::string& JSONReader::GetLoadProblems() const {
+        return load_problems_;
+    }
+
+    void JSONReader::LoadFromJsonIncremental(const json::Document& input) {
 
         // В цикле обрабатываем остановки и маршруты
-        for (const auto& req_node : base_requests) {
+        for (const auto& req_node : GetBaseRequests(input)) {
             const json::Dict& req = req_node.AsDict();
             std::string type = req.at("type").AsString();
 
@@ -39,6 +56,64 @@ namespace json_reader {
         }
     }
 
+    void JSONReader::LoadBulk(const json::Array& base_requests) {
+        trans_cat::CatalogueBuilder builder;
+        builder.Reserve(base_requests.size(), base_requests.size(), 0);
+
+        // Строки не копируем: builder хранит string_view на узлы документа
+        for (const auto& req_node : base_requests) {
+            const json::Dict& req = req_node.AsDict();
+            const std::string& type = GetJsonNode(req, "type").AsString();
+            const std::string& name = GetJsonNode(req, "name").AsString();
+
+            if (type == "Stop") {
+                builder.AddStop(name, { GetJsonValue<double>(req, "latitude"), GetJsonValue<double>(req, "longitude") });
+
+                if (auto dist_it = req.find("road_distances"); dist_it != req.end()) {
+                    for (const auto& [to, dist_node] : dist_it->second.AsDict()) {
+                        builder.SetDistance(name, to, dist_node.AsInt());
+                    }
+                }
+            }
+            else if (type == "Bus") {
+                const json::Array& stops_array = GetJsonNode(req, "stops").AsArray();
+                std::vector<std::string_view> stops;
+                stops.reserve(stops_array.size());
+                for (const auto& stop_node : stops_array) {
+                    stops.push_back(stop_node.AsString());
+                }
+                builder.AddRoute(name, std::move(stops), GetJsonValue<bool>(req, "is_roundtrip"));
+            }
+            else {
+                throw json::ParsingError("Unknown base request type: " + type);
+            }
+        }
+
+        builder.Build(catalogue_);
+    }
+
+    const json::Array& JSONReader::GetBaseRequests(const json::Document& input) {
+
+        // Читаем root из json'а
+        const json::Dict& root = input.GetRoot().AsDict();
+
+        // Попытка найти в root узел 'base_requests'
+        auto it = root.find("base_requests");
+        if (it == root.end()) {
+            throw json::ParsingError("Missing 'base_requests' in input");
+        }
+
+        return it->second.AsArray();
+    }
+
+    const json::Node& JSONReader::GetJsonNode(const json::Dict& dict, std::string_view key) {
+        auto it = dict.find(std::string(key));
+        if (it == dict.end()) {
+            throw json::ParsingError{ std::string("Key not found: ") + std::string(key) };
+        }
+        return it->second;
+    }
+
     json::Array JSONReader::GetStatRequests(const json::Document& input) {
         const auto& root = input.GetRoot().AsDict();
         if (root.count("stat_requests")) {
@@ -91,10 +166,38 @@ namespace json_reader {
         const auto& root = input.GetRoot().AsDict();
         const auto& rs = root.at("routing_settings").AsDict();
 
-        return transport_router::RoutingSettings{
+        transport_router::RoutingSettings settings{
             .bus_wait_time = rs.at("bus_wait_time").AsInt(),
             .bus_velocity = rs.at("bus_velocity").AsDouble()
         };
+
+        // Необязательные параметры выбора стратегии поиска маршрутов
+        if (auto it = rs.find("strategy"); it != rs.end()) {
+            const auto strategy = transport_router::ParseRoutingStrategy(it->second.AsString());
+            if (!strategy) {
+                throw json::ParsingError("Unknown routing strategy: " + it->second.AsString());
+            }
+            settings.strategy = *strategy;
+        }
+        if (auto it = rs.find("memory_limit_mb"); it != rs.end()) {
+            const double megabytes = it->second.AsDouble();
+            if (megabytes < 0) {
+                throw json::ParsingError("memory_limit_mb must be non-negative");
+            }
+            settings.memory_limit_bytes = static_cast<size_t>(megabytes * 1024.0 * 1024.0);
+        }
+        if (auto it = rs.find("landmark_count"); it != rs.end()) {
+            const int landmark_count = it->second.AsInt();
+            if (landmark_count < 0) {
+                throw json::ParsingError("landmark_count must be non-negative");
+            }
+            settings.landmark_count = static_cast<size_t>(landmark_count);
+        }
+        if (auto it = rs.find("collect_stats"); it != rs.end()) {
+            settings.collect_stats = it->second.AsBool();
+        }
+
+        return settings;
     }
 
     void JSONReader::AddStopFromJSON(const json::Dict& stop_node) {
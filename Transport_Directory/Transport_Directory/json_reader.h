@@ -9,7 +9,13 @@
 #include <string_view>
 
 namespace json_reader {
-	
+
+	/// Режим проверки входных данных при загрузке каталога
+	enum class Validation {
+		Lenient,	///< Несогласованные данные загружаются как раньше: заглушки вместо неописанных остановок, повторы перезаписываются
+		Strict		///< Несогласованные данные — ошибка (std::invalid_argument), каталог остаётся пустым
+	};
+
 	/**
 	 * @brief Утилита для парсинга JSON-входа и заполнения транспортного каталога.
 	 *
@@ -37,10 +43,36 @@ namespace json_reader {
 		 * - устанавливает дорожные расстояния между остановками
 		 *
 		 * @param input JSON-документ с ключом "base_requests"
+		 * @param validation Режим проверки данных (по умолчанию — нестрогий)
+		 * Пустой каталог заполняется пакетно (trans_cat::CatalogueBuilder), непустой —
+		 * поштучно (см. LoadFromJsonIncremental). Если пакетная загрузка отвергла вход
+		 * (ссылки на неописанные остановки, повторы имён и т. п.), в нестрогом режиме данные
+		 * загружаются поштучно с прежней семантикой (заглушки, перезапись повторов),
+		 * а найденные проблемы доступны через GetLoadProblems().
+		 *
 		 * @throw json::ParsingError если формат JSON нарушен или отсутствуют обязательные поля
+		 * @throw std::invalid_argument если данные несогласованы (только Validation::Strict
+		 *        и пустой каталог)
 		 *
 		 */
-		void LoadFromJson(const json::Document& input);
+		void LoadFromJson(const json::Document& input, Validation validation = Validation::Lenient);
+
+		/**
+		 * @brief Проблемы во входных данных, найденные последним вызовом LoadFromJson.
+		 * @return Сообщение пакетной проверки или пустая строка, если проблем не было
+		 */
+		const std::string& GetLoadProblems() const;
+
+		/**
+		 * @brief Загружает данные поштучно: AddStop/SetDistance/AddRoute в порядке base_requests.
+		 *
+		 * Подписчики каталога получают событие на каждое изменение; остановки,
+		 * на которые ссылаются маршруты и расстояния, но которые не описаны, создаются
+		 * как заглушки без координат.
+		 *
+		 * @throw json::ParsingError если формат JSON нарушен или отсутствуют обязательные поля
+		 */
+		void LoadFromJsonIncremental(const json::Document& input);
 
 		/**
 		 * @brief Извлекает массив статистических запросов из входного документа.
@@ -103,12 +135,20 @@ namespace json_reader {
 		// Внутренние методы
 		void AddStopFromJSON(const json::Dict& stop_node);
 		void AddRouteFromJSON(const json::Dict& route_node);
+		void LoadBulk(const json::Array& base_requests);
+
+		// Массив "base_requests" входного документа
+		static const json::Array& GetBaseRequests(const json::Document& input);
+
+		// Узел по ключу без копирования значения
+		static const json::Node& GetJsonNode(const json::Dict& dict, std::string_view key);
 
 		// Утилита: безопасное извлечение значения по ключу
 		template<typename T>
 		T GetJsonValue(const json::Dict& dict, std::string_view key) const;
 
 		trans_cat::TransportCatalogue& catalogue_;	///< Ссылка на каталог — заполняется при загрузке
+		std::string load_problems_;					///< Проблемы, найденные последней загрузкой
 	};
 
 	template<typename T>
@@ -0,0 +1,302 @@
+#pragma once
+
+#include "graph.h"
+#include "dijkstra.h"
+#include "parallel.h"
+
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+/**
+ * @file landmarks.h
+ * @brief Ориентиры (landmarks) для эвристики A* — алгоритм ALT.
+ *
+ * Для нескольких вершин-ориентиров L заранее вычисляются расстояния d(L, v)
+ * и d(v, L) до всех вершин графа. По неравенству треугольника
+ *     d(v, t) >= d(L, t) - d(L, v)   и   d(v, t) >= d(v, L) - d(t, L),
+ * максимум этих оценок по всем ориентирам — допустимая и согласованная
+ * эвристика для поиска от v к цели t. С ней FindShortestPath раскрывает
+ * в основном вершины "по пути" к цели, а не весь круг радиусом d(from, to).
+ *
+ * @tparam Weight — тип веса рёбер (должен поддерживать операции +, -, <)
+ */
+
+namespace graph {
+
+	/**
+	 * @brief Расстояния от ориентиров и до них для всех вершин графа.
+	 *
+	 * Ориентиры выбираются жадно — каждый следующий максимально удалён
+	 * от уже выбранных, что даёт ориентиры "на окраинах" сети.
+	 *
+	 * @note Индекс не следит за изменениями графа. Рост весов и удаление рёбер
+	 *       оценки не нарушают (расстояния только растут), новые вершины получают
+	 *       нулевую оценку; после добавления или удешевления рёбер индекс нужно
+	 *       построить заново.
+	 * @note Память: 2·K·V значений, расстояния вершины хранятся подряд.
+	 * @note Сложность построения: O(K·(V + E) log V).
+	 */
+	template <typename Weight>
+	class LandmarkIndex {
+	private:
+		using Graph = DirectedWeightedGraph<Weight>;  ///< Удобный псевдоним
+
+	public:
+		/**
+		 * @brief Эвристика поиска к фиксированной цели (для FindShortestPath).
+		 *
+		 * Хранит расстояния цели до ориентиров, чтобы не искать их для каждой вершины.
+		 */
+		class Potential {
+		public:
+			/// Нижняя оценка веса пути от vertex до цели (бесконечность — цель недостижима)
+			Weight operator()(VertexId vertex) const;
+
+		private:
+			friend class LandmarkIndex;
+
+			Potential(const LandmarkIndex& index, VertexId target);
+
+			const LandmarkIndex& index_;
+			std::vector<Weight> target_from_;  ///< d(L, цель) по ориентирам
+			std::vector<Weight> target_to_;    ///< d(цель, L) по ориентирам
+		};
+
+		/**
+		 * @brief Выбирает ориентиры и вычисляет расстояния.
+		 * @param graph Граф (не хранится)
+		 * @param landmark_count Желаемое число ориентиров (не больше числа вершин)
+		 * @throw std::domain_error, если встречено ребро с отрицательным весом
+		 */
+		LandmarkIndex(const Graph& graph, size_t landmark_count);
+
+		/// Эвристика для поиска к вершине target (нулевая, если target нет в индексе)
+		Potential MakePotential(VertexId target) const;
+
+		/// Выбранные ориентиры
+		const std::vector<VertexId>& GetLandmarks() const;
+
+		/// Число вершин графа, для которого построен индекс
+		size_t GetVertexCount() const;
+
+		/// Объём памяти под расстояния, байт
+		size_t GetMemoryUsage() const;
+
+		/// Оценка памяти индекса для графа с заданным числом вершин, байт
+		static size_t EstimateMemory(size_t vertex_count, size_t landmark_count);
+
+	private:
+		/// Расстояние до недостижимой вершины
+		static constexpr Weight UNREACHABLE = std::numeric_limits<Weight>::has_infinity
+			? std::numeric_limits<Weight>::infinity()
+			: std::numeric_limits<Weight>::max();
+
+		/// Индекс расстояния вершины vertex для ориентира landmark (расстояния вершины — подряд)
+		size_t Index(VertexId vertex, size_t landmark) const {
+			return vertex * landmarks_.size() + landmark;
+		}
+
+		// Граф с развёрнутыми рёбрами: поиск в нём даёт расстояния до вершины
+		static Graph Reverse(const Graph& graph);
+
+		// Выбирает ориентиры, заполняя расстояния от них
+		void SelectLandmarks(const Graph& graph, size_t landmark_count);
+
+		size_t vertex_count_ = 0;
+		std::vector<VertexId> landmarks_;
+		std::vector<Weight> from_landmark_;  ///< d(L, v): [вершина][ориентир]
+		std::vector<Weight> to_landmark_;    ///< d(v, L): [вершина][ориентир]
+	};
+
+	// ====================================================
+	// Реализация методов
+	// ====================================================
+
+	template <typename Weight>
+	LandmarkIndex<Weight>::LandmarkIndex(const Graph& graph, size_t landmark_count)
+		: vertex_count_(graph.GetVertexCount())
+	{
+		SelectLandmarks(graph, std::min(landmark_count, vertex_count_));
+
+		// Расстояния до ориентиров — поиски в развёрнутом графе, независимые друг от друга
+		const Graph reversed = Reverse(graph);
+		to_landmark_.assign(vertex_count_ * landmarks_.size(), UNREACHABLE);
+
+		std::vector<size_t> order(landmarks_.size());
+		std::iota(order.begin(), order.end(), 0);
+		parallel::ForEach(order.begin(), order.end(), [&](size_t k) {
+			ShortestPathTree<Weight> tree(reversed, landmarks_[k]);
+			for (VertexId vertex : tree.GetSettledVertices()) {
+				to_landmark_[Index(vertex, k)] = *tree.GetWeight(vertex);
+			}
+		});
+	}
+
+	/**
+	 * Жадный выбор "самой дальней вершины": первый ориентир — самая удалённая
+	 * от вершины с наибольшей выходной степенью (узла основной части сети),
+	 * каждый следующий — с наибольшим расстоянием до ближайшего из уже выбранных.
+	 * Недостижимые вершины (изолированные остановки, другие компоненты) берутся,
+	 * только когда достижимых не осталось: ориентир в них бесполезен для остальной сети.
+	 * Расстояния от ориентира сохраняются по ходу выбора.
+	 */
+	template <typename Weight>
+	void LandmarkIndex<Weight>::SelectLandmarks(const Graph& graph, size_t landmark_count) {
+		landmarks_.reserve(landmark_count);
+		std::vector<std::vector<Weight>> distances;  // [ориентир][вершина] — до перекладки
+		distances.reserve(landmark_count);
+
+		auto compute_distances = [&graph, this](VertexId source) {
+			std::vector<Weight> row(vertex_count_, UNREACHABLE);
+			ShortestPathTree<Weight> tree(graph, source);
+			for (VertexId vertex : tree.GetSettledVertices()) {
+				row[vertex] = *tree.GetWeight(vertex);
+			}
+			return row;
+		};
+
+		// Расстояние от ближайшего выбранного ориентира; для первого — от узла сети
+		std::vector<Weight> nearest;
+		if (landmark_count > 0) {
+			auto out_degree = [&graph](VertexId vertex) {
+				const auto edges = graph.GetIncidentEdges(vertex);
+				return std::distance(edges.begin(), edges.end());
+			};
+			VertexId hub = 0;
+			for (VertexId vertex = 1; vertex < vertex_count_; ++vertex) {
+				if (out_degree(hub) < out_degree(vertex)) {
+					hub = vertex;
+				}
+			}
+			nearest = compute_distances(hub);
+		}
+
+		std::vector<bool> chosen(vertex_count_, false);
+		while (landmarks_.size() < landmark_count) {
+			VertexId best = vertex_count_;
+			for (VertexId vertex = 0; vertex < vertex_count_; ++vertex) {
+				if (chosen[vertex]) {
+					continue;
+				}
+				const bool reachable = nearest[vertex] != UNREACHABLE;
+				const bool best_reachable = best != vertex_count_ && nearest[best] != UNREACHABLE;
+				if (best == vertex_count_ || (reachable && (!best_reachable || nearest[best] < nearest[vertex]))) {
+					best = vertex;
+				}
+			}
+
+			chosen[best] = true;
+			landmarks_.push_back(best);
+			const auto& row = distances.emplace_back(compute_distances(best));
+
+			// Первый ориентир заменяет оценку от узла сети
+			for (VertexId vertex = 0; vertex < vertex_count_; ++vertex) {
+				nearest[vertex] = landmarks_.size() == 1 ? row[vertex] : std::min(nearest[vertex], row[vertex]);
+			}
+		}
+
+		from_landmark_.assign(vertex_count_ * landmarks_.size(), UNREACHABLE);
+		for (size_t k = 0; k < landmarks_.size(); ++k) {
+			for (VertexId vertex = 0; vertex < vertex_count_; ++vertex) {
+				from_landmark_[Index(vertex, k)] = distances[k][vertex];
+			}
+		}
+	}
+
+	template <typename Weight>
+	typename LandmarkIndex<Weight>::Graph LandmarkIndex<Weight>::Reverse(const Graph& graph) {
+		Graph reversed(graph.GetVertexCount());
+		reversed.ReserveEdges(graph.GetEdgeCount());
+		for (VertexId vertex = 0; vertex < graph.GetVertexCount(); ++vertex) {
+			// Только рёбра из списков инцидентности: исключённые рёбра в них отсутствуют
+			for (EdgeId edge_id : graph.GetIncidentEdges(vertex)) {
+				const auto& edge = graph.GetEdge(edge_id);
+				reversed.AddEdge(Edge<Weight>{ edge.to, edge.from, edge.weight });
+			}
+		}
+		return reversed;
+	}
+
+	template <typename Weight>
+	typename LandmarkIndex<Weight>::Potential LandmarkIndex<Weight>::MakePotential(VertexId target) const {
+		return Potential(*this, target);
+	}
+
+	template <typename Weight>
+	const std::vector<VertexId>& LandmarkIndex<Weight>::GetLandmarks() const {
+		return landmarks_;
+	}
+
+	template <typename Weight>
+	size_t LandmarkIndex<Weight>::GetVertexCount() const {
+		return vertex_count_;
+	}
+
+	template <typename Weight>
+	size_t LandmarkIndex<Weight>::GetMemoryUsage() const {
+		return (from_landmark_.capacity() + to_landmark_.capacity()) * sizeof(Weight);
+	}
+
+	template <typename Weight>
+	size_t LandmarkIndex<Weight>::EstimateMemory(size_t vertex_count, size_t landmark_count) {
+		return 2 * std::min(landmark_count, vertex_count) * vertex_count * sizeof(Weight);
+	}
+
+	template <typename Weight>
+	LandmarkIndex<Weight>::Potential::Potential(const LandmarkIndex& index, VertexId target)
+		: index_(index)
+	{
+		if (target >= index.vertex_count_) {
+			return;  // Цель добавлена после построения — оценок нет
+		}
+		target_from_.resize(index.landmarks_.size());
+		target_to_.resize(index.landmarks_.size());
+		for (size_t k = 0; k < index.landmarks_.size(); ++k) {
+			target_from_[k] = index.from_landmark_[index.Index(target, k)];
+			target_to_[k] = index.to_landmark_[index.Index(target, k)];
+		}
+	}
+
+	/**
+	 * Недостижимость в оценках не даёт конечной нижней границы, но иногда
+	 * доказывает, что цель недостижима из вершины:
+	 * - d(L, v) конечно, а d(L, t) — нет: иначе L достиг бы t через v;
+	 * - d(t, L) конечно, а d(v, L) — нет: иначе v достигла бы L через t.
+	 * Тогда (для типов с бесконечностью) возвращается бесконечность — FindShortestPath
+	 * такие вершины не раскрывает. Если вершина или цель добавлены в граф после
+	 * построения индекса, оценка нулевая (поиск вырождается в Дейкстру).
+	 */
+	template <typename Weight>
+	Weight LandmarkIndex<Weight>::Potential::operator()(VertexId vertex) const {
+		Weight bound{};
+		if (target_from_.empty() || vertex >= index_.vertex_count_) {
+			return bound;
+		}
+
+		const Weight* from = &index_.from_landmark_[index_.Index(vertex, 0)];
+		const Weight* to = &index_.to_landmark_[index_.Index(vertex, 0)];
+		for (size_t k = 0; k < target_from_.size(); ++k) {
+			const bool from_known = from[k] != UNREACHABLE;
+			const bool to_known = to[k] != UNREACHABLE;
+			const bool target_from_known = target_from_[k] != UNREACHABLE;
+			const bool target_to_known = target_to_[k] != UNREACHABLE;
+
+			if constexpr (std::numeric_limits<Weight>::has_infinity) {
+				if ((from_known && !target_from_known) || (target_to_known && !to_known)) {
+					return UNREACHABLE;
+				}
+			}
+			if (from_known && target_from_known && bound < target_from_[k] - from[k]) {
+				bound = target_from_[k] - from[k];
+			}
+			if (to_known && target_to_known && bound < to[k] - target_to_[k]) {
+				bound = to[k] - target_to_[k];
+			}
+		}
+		return bound;
+	}
+
+}  // namespace graph
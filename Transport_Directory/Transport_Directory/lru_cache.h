@@ -0,0 +1,201 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * @file lru_cache.h
+ * @brief Потокобезопасный ограниченный кэш с вытеснением давно не использованных записей (LRU).
+ *
+ * Ключи распределяются по шардам по хэшу; у каждого шарда свой мьютекс,
+ * свой список LRU и своя доля ёмкости. Благодаря этому параллельные
+ * обращения к разным шардам не конкурируют за одну блокировку.
+ */
+
+namespace cache {
+
+	/// Счётчики обращений к кэшу
+	struct CacheStats {
+		uint64_t hits = 0;          ///< Найдено в кэше
+		uint64_t misses = 0;        ///< Не найдено в кэше
+		uint64_t evictions = 0;     ///< Вытеснено при переполнении
+		size_t size = 0;            ///< Текущее число записей
+		size_t capacity = 0;        ///< Максимальное число записей
+	};
+
+	/**
+	 * @brief Шардированный LRU-кэш.
+	 *
+	 * @tparam Key — тип ключа (копируемый, сравнимый на равенство)
+	 * @tparam Value — тип значения (копируется при чтении; для тяжёлых значений
+	 *         храните std::shared_ptr<const T>)
+	 * @tparam Hash — хэшер ключа
+	 *
+	 * @note Все методы потокобезопасны.
+	 * @note Сложность Get/Put: O(1) в среднем.
+	 */
+	template <typename Key, typename Value, typename Hash = std::hash<Key>>
+	class ShardedLruCache {
+	public:
+		/**
+		 * @brief Создаёт кэш.
+		 * @param capacity Общая ёмкость (не меньше 1). Делится между шардами с точностью
+		 *        до записи: GetStats().capacity равна capacity
+		 * @param shard_count Число шардов (не больше capacity — у каждого шарда хотя бы одна запись)
+		 */
+		explicit ShardedLruCache(size_t capacity, size_t shard_count = 16);
+
+		ShardedLruCache(const ShardedLruCache&) = delete;
+		ShardedLruCache& operator=(const ShardedLruCache&) = delete;
+
+		/**
+		 * @brief Ищет значение и помечает запись как недавно использованную.
+		 * @return Копия значения или std::nullopt
+		 */
+		std::optional<Value> Get(const Key& key);
+
+		/**
+		 * @brief Добавляет (или заменяет) значение.
+		 *
+		 * При переполнении шарда вытесняется самая давно использованная запись.
+		 */
+		void Put(const Key& key, Value value);
+
+		/// Проверяет наличие записи, не меняя порядок вытеснения и счётчики обращений
+		bool Contains(const Key& key) const;
+
+		/// Удаляет все записи (счётчики обращений сохраняются)
+		void Clear();
+
+		/// Возвращает счётчики обращений и заполненность
+		CacheStats GetStats() const;
+
+	private:
+		/// Одна независимая часть кэша
+		struct Shard {
+			using Entry = std::pair<Key, Value>;
+
+			mutable std::mutex mutex;
+			size_t capacity = 1;        ///< Доля общей ёмкости
+			std::list<Entry> entries;   ///< В начале — недавно использованные
+			std::unordered_map<Key, typename std::list<Entry>::iterator, Hash> index;
+		};
+
+		Shard& GetShard(const Key& key);
+		const Shard& GetShard(const Key& key) const;
+
+		Hash hasher_;
+		size_t capacity_;
+		std::vector<Shard> shards_;
+
+		std::atomic<uint64_t> hits_ = 0;
+		std::atomic<uint64_t> misses_ = 0;
+		std::atomic<uint64_t> evictions_ = 0;
+	};
+
+	// ====================================================
+	// Реализация методов
+	// ====================================================
+
+	template <typename Key, typename Value, typename Hash>
+	ShardedLruCache<Key, Value, Hash>::ShardedLruCache(size_t capacity, size_t shard_count)
+		: capacity_(std::max<size_t>(1, capacity))
+		, shards_(std::clamp<size_t>(shard_count, 1, capacity_))
+	{
+		// Остаток от деления достаётся первым шардам по одной записи
+		for (size_t i = 0; i < shards_.size(); ++i) {
+			shards_[i].capacity = capacity_ / shards_.size() + (i < capacity_ % shards_.size() ? 1 : 0);
+		}
+	}
+
+	template <typename Key, typename Value, typename Hash>
+	typename ShardedLruCache<Key, Value, Hash>::Shard&
+		ShardedLruCache<Key, Value, Hash>::GetShard(const Key& key) {
+		return shards_[hasher_(key) % shards_.size()];
+	}
+
+	template <typename Key, typename Value, typename Hash>
+	const typename ShardedLruCache<Key, Value, Hash>::Shard&
+		ShardedLruCache<Key, Value, Hash>::GetShard(const Key& key) const {
+		return shards_[hasher_(key) % shards_.size()];
+	}
+
+	template <typename Key, typename Value, typename Hash>
+	std::optional<Value> ShardedLruCache<Key, Value, Hash>::Get(const Key& key) {
+		Shard& shard = GetShard(key);
+		std::lock_guard guard(shard.mutex);
+
+		auto it = shard.index.find(key);
+		if (it == shard.index.end()) {
+			misses_.fetch_add(1, std::memory_order_relaxed);
+			return std::nullopt;
+		}
+
+		// Переносим запись в начало списка — она использована последней
+		shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+		hits_.fetch_add(1, std::memory_order_relaxed);
+		return it->second->second;
+	}
+
+	template <typename Key, typename Value, typename Hash>
+	void ShardedLruCache<Key, Value, Hash>::Put(const Key& key, Value value) {
+		Shard& shard = GetShard(key);
+		std::lock_guard guard(shard.mutex);
+
+		if (auto it = shard.index.find(key); it != shard.index.end()) {
+			it->second->second = std::move(value);
+			shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+			return;
+		}
+
+		shard.entries.emplace_front(key, std::move(value));
+		shard.index.emplace(key, shard.entries.begin());
+
+		// Вытесняем самую давно использованную запись
+		if (shard.entries.size() > shard.capacity) {
+			shard.index.erase(shard.entries.back().first);
+			shard.entries.pop_back();
+			evictions_.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+
+	template <typename Key, typename Value, typename Hash>
+	bool ShardedLruCache<Key, Value, Hash>::Contains(const Key& key) const {
+		const Shard& shard = GetShard(key);
+		std::lock_guard guard(shard.mutex);
+		return shard.index.count(key) > 0;
+	}
+
+	template <typename Key, typename Value, typename Hash>
+	void ShardedLruCache<Key, Value, Hash>::Clear() {
+		for (Shard& shard : shards_) {
+			std::lock_guard guard(shard.mutex);
+			shard.index.clear();
+			shard.entries.clear();
+		}
+	}
+
+	template <typename Key, typename Value, typename Hash>
+	CacheStats ShardedLruCache<Key, Value, Hash>::GetStats() const {
+		CacheStats stats;
+		stats.hits = hits_.load(std::memory_order_relaxed);
+		stats.misses = misses_.load(std::memory_order_relaxed);
+		stats.evictions = evictions_.load(std::memory_order_relaxed);
+		stats.capacity = capacity_;
+
+		for (const Shard& shard : shards_) {
+			std::lock_guard guard(shard.mutex);
+			stats.size += shard.entries.size();
+		}
+		return stats;
+	}
+
+}  // namespace cache
@@ -1,20 +1,54 @@
 #include "json_reader.h"
 #include "request_handler.h"
+#include "profiler.h"
+#include "input_buffer.h"
 
 #include <iostream>
 #include <exception>
+#include <string>
 
-int main() {
+// Сборка (из каталога Transport_Directory/Transport_Directory):
+//   g++ -std=c++20 -O2 -pthread -o transport_directory $(ls *.cpp | grep -v -e input_reader -e stat_reader) -ltbb
+//   -ltbb нужен для std::execution::par в libstdc++ (см. parallel.h); без TBB — последовательная сборка:
+//   g++ -std=c++20 -O2 -pthread -DTRANSPORT_NO_PARALLEL -o transport_directory $(ls *.cpp | grep -v -e input_reader -e stat_reader)
+//
+// Запуск: transport_directory [--strict] [input.json] — без файла (или с "-") вход читается из stdin.
+// --strict: несогласованные base_requests (неописанные остановки, повторы имён) — ошибка, а не предупреждение
+int main(int argc, char** argv) {
+    // Отчёт профилировщика: PROFILER_REPORT=1 (stderr) и/или PROFILER_JSON=<файл>
+    PROFILE_FUNCTION();
     try {
-        // Читаем весь входной JSON
-        json::Document input = json::Load(std::cin);
+        // Читаем весь входной JSON: файл отображается в память и разбирается как непрерывный буфер.
+        // Документ хранит свои копии строк, поэтому буфер освобождается сразу после разбора
+        int arg = 1;
+        const bool strict = arg < argc && std::string(argv[arg]) == "--strict";
+        if (strict) {
+            ++arg;
+        }
+
+        json::Document input = [&] {
+            const std::string path = arg < argc ? argv[arg] : "-";
+            const auto text = [&] {
+                PROFILE_SCOPE("read input");
+                return path == "-" ? input_buffer::InputBuffer::FromStdin()
+                                   : input_buffer::InputBuffer::FromFile(path);
+            }();
+            PROFILE_SCOPE("json::Load");
+            return json::Load(text.GetView());
+        }();
 
         // Создаём каталог
         trans_cat::TransportCatalogue catalogue;
 
         // Загружаем базовые данные (остановки и маршруты)
         json_reader::JSONReader reader(catalogue);
-        reader.LoadFromJson(input);
+        reader.LoadFromJson(input, strict ? json_reader::Validation::Strict : json_reader::Validation::Lenient);
+        if (!reader.GetLoadProblems().empty()) {
+            std::cerr << "Warning: " << reader.GetLoadProblems() << std::endl;
+        }
+
+        // Дальше каталог только читается: заморозка включает быстрые индексы имён
+        catalogue.Freeze();
 
         // Создаём обработчик запросов
         auto handler = request_handler::RequestHandler::Create(catalogue, input);
@@ -22,6 +56,11 @@ int main() {
         // Обрабатываем статистические запросы и выводим ответ
         handler.ProcessRequests(std::cout);
 
+        // Статистика маршрутизатора (routing_settings.collect_stats) — в stderr при выходе
+        if (const auto* stats = handler.GetRoutingStats()) {
+            stats->Print(std::cerr);
+        }
+
         return 0;
     }
     catch (const json::ParsingError& e) {
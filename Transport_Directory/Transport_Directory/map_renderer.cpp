@@ -1,6 +1,7 @@
 #include <cmath>
 
 #include "map_renderer.h"
+#include "profiler.h"
 #include <algorithm>
 
 using namespace renderer;
@@ -10,10 +11,11 @@ renderer::MapRenderer::MapRenderer(const RenderSettings& settings)
 }
 
 svg::Document MapRenderer::RenderMap(const trans_cat::TransportCatalogue& catalogue) const {
+    PROFILE_FUNCTION();
     svg::Document doc;
 
     std::set<const trans_cat::Stop*> stop_set;
-    std::set<std::string> route_names;
+    std::set<std::string_view> route_names;
 
     for (const auto& route : catalogue.GetRoutesSortedByName()) {
         route_names.insert(route->name);
@@ -141,7 +143,7 @@ void MapRenderer::RenderBusLabels(svg::Document& doc,
                 .SetStrokeWidth(settings_.underlayer_width)
                 .SetStrokeLineCap(svg::StrokeLineCap::ROUND)
                 .SetStrokeLineJoin(svg::StrokeLineJoin::ROUND)
-                .SetData(route->name);
+                .SetData(std::string(route->name));
             doc.Add(under);
 
             // Основная надпись — только заливка
@@ -153,7 +155,7 @@ void MapRenderer::RenderBusLabels(svg::Document& doc,
                 .SetFontFamily("Verdana")
                 .SetFontWeight("bold")
                 .SetFillColor(color)
-                .SetData(route->name);
+                .SetData(std::string(route->name));
             doc.Add(label);
             };
 
@@ -199,7 +201,7 @@ void MapRenderer::RenderStopLabels(svg::Document& doc,
             .SetStrokeWidth(settings_.underlayer_width)
             .SetStrokeLineCap(svg::StrokeLineCap::ROUND)
             .SetStrokeLineJoin(svg::StrokeLineJoin::ROUND)
-            .SetData(stop->name);
+            .SetData(std::string(stop->name));
         doc.Add(under);
 
         // Текст
@@ -210,7 +212,7 @@ void MapRenderer::RenderStopLabels(svg::Document& doc,
             .SetFontSize(settings_.stop_label_font_size)
             .SetFontFamily("Verdana")
             .SetFillColor("black")
-            .SetData(stop->name);
+            .SetData(std::string(stop->name));
         doc.Add(label);
     }
 }
\ No newline at end of file
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <algorithm>
+
+#ifndef TRANSPORT_NO_PARALLEL
+#include <execution>
+#endif
+
+/**
+ * @file parallel.h
+ * @brief Параллельные варианты стандартных алгоритмов с последовательным запасным путём.
+ *
+ * По умолчанию вызовы идут через std::execution::par. В libstdc++ параллельная
+ * политика реализована поверх Intel TBB: если заголовки TBB установлены, бинарник
+ * нужно линковать с -ltbb, иначе сборка падает на этапе компоновки.
+ * Для сборки без TBB определите TRANSPORT_NO_PARALLEL (-DTRANSPORT_NO_PARALLEL):
+ * алгоритмы выполнятся последовательно, результаты от этого не меняются —
+ * все параллельные участки обрабатывают независимые элементы.
+ */
+
+namespace parallel {
+
+	/// std::for_each по независимым элементам
+	template <typename It, typename Func>
+	void ForEach(It first, It last, Func func) {
+#ifdef TRANSPORT_NO_PARALLEL
+		std::for_each(first, last, func);
+#else
+		std::for_each(std::execution::par, first, last, func);
+#endif
+	}
+
+	/// std::transform по независимым элементам
+	template <typename It, typename OutIt, typename Func>
+	OutIt Transform(It first, It last, OutIt out, Func func) {
+#ifdef TRANSPORT_NO_PARALLEL
+		return std::transform(first, last, out, func);
+#else
+		return std::transform(std::execution::par, first, last, out, func);
+#endif
+	}
+
+} // namespace parallel
@@ -1,12 +1,25 @@
 ﻿#include "request_handler.h"
 #include "json_reader.h"
 #include "json_builder.h"
+#include "profiler.h"
+#include <algorithm>
 #include <sstream>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace request_handler {
 
 	using namespace std::string_literals;
 
+	size_t RouteCacheKeyHash::operator()(const RouteCacheKey& key) const {
+		size_t seed = 0;
+		trans_cat::hash_combine(seed, key.from);
+		trans_cat::hash_combine(seed, key.to);
+		trans_cat::hash_combine(seed, key.router_version);
+		trans_cat::hash_combine(seed, key.alternatives);
+		return seed;
+	}
+
 	RequestHandler::RequestHandler(const trans_cat::TransportCatalogue& catalogue,
 								std::optional<renderer::MapRenderer> renderer,
 								std::optional<json::Array> stat_requests,
@@ -22,9 +35,15 @@ namespace request_handler {
 		processor_.AddHandler("Stop", [this](const json::Dict& req) { return ProcessStopRequest(req); });
 		processor_.AddHandler("Map", [this](const json::Dict& req) { return ProcessMapRequest(req); });
 		processor_.AddHandler("Route", [this](const json::Dict& req) { return ProcessRouteRequest(req); });
+		processor_.AddHandler("RouteMatrix", [this](const json::Dict& req) { return ProcessRouteMatrixRequest(req); });
+		processor_.AddHandler("Isochrone", [this](const json::Dict& req) { return ProcessIsochroneRequest(req); });
+		processor_.AddHandler("Diagnostics", [this](const json::Dict& req) { return ProcessDiagnosticsRequest(req); });
+		processor_.AddHandler("StopSearch", [this](const json::Dict& req) { return ProcessStopSearchRequest(req); });
+		processor_.AddHandler("Stats", [this](const json::Dict& req) { return ProcessStatsRequest(req); });
 	}
 
 	json::Dict RequestHandler::ProcessBusRequest(const json::Dict& req) const {
+		PROFILE_FUNCTION();
 		auto stat = GetBusStat(req.at("name").AsString());
 		int id = req.at("id").AsInt();
 
@@ -44,16 +63,20 @@ namespace request_handler {
 	}
 
 	json::Dict RequestHandler::ProcessStopRequest(const json::Dict& req) const {
-		auto stat = GetStopStat(req.at("name").AsString());
+		PROFILE_FUNCTION();
+		const trans_cat::Stop* stop = catalogue_.FindStop(req.at("name").AsString());
 		int id = req.at("id").AsInt();
 
-		if (!stat) {
+		if (!stop) {
 			return MakeErrorResponse(id, "not found");
 		}
 
+		// Имена берём прямо из маршрутов каталога, без промежуточного вектора строк
+		const auto routes = catalogue_.GetBusesByStop(stop);
 		json::Array buses;
-		for (const auto& bus : stat->bus_names) {
-			buses.push_back(json::Node(bus));
+		buses.reserve(routes.size());
+		for (const trans_cat::Route* route : routes) {
+			buses.emplace_back(std::string(route->name));
 		}
 
 		return json::Builder{}
@@ -65,41 +88,104 @@ namespace request_handler {
 	}
 
 	json::Dict RequestHandler::ProcessMapRequest(const json::Dict& req) const {
+		PROFILE_FUNCTION();
 		int id = req.at("id").AsInt();
 
 		if (!map_renderer_) {
 			return MakeErrorResponse(id, "render settings are not provided");
 		}
 
-		svg::Document doc = map_renderer_->RenderMap(catalogue_);
-		std::ostringstream ss;
-		doc.Render(ss);
+		// Карта зависит только от каталога — рисуем заново, только если он изменился с прошлой отрисовки.
+		// Отрисовка под блокировкой: параллельные запросы не рисуют одну и ту же карту дважды
+		std::shared_ptr<const std::string> svg;
+		{
+			std::lock_guard lock(map_mutex_);
+			const uint64_t version = catalogue_.GetChangeVersion();
+			if (!map_cache_.svg || map_cache_.catalogue_version != version) {
+				svg::Document doc = map_renderer_->RenderMap(catalogue_);
+				std::ostringstream ss;
+				doc.Render(ss);
+				map_cache_ = CachedMap{ version, std::make_shared<const std::string>(ss.str()) };
+			}
+			svg = map_cache_.svg;
+		}
 
 		return json::Builder{}
 			.StartDict()
 			.Key("request_id").Value(id)
-			.Key("map").Value(ss.str())
+			.Key("map").Value(*svg)
 			.EndDict()
 			.Build().AsDict();
 	}
 
 	json::Dict RequestHandler::ProcessRouteRequest(const json::Dict& req) const {
+		PROFILE_FUNCTION();
 		int id = req.at("id").AsInt();
-		std::string from = req.at("from").AsString();
-		std::string to = req.at("to").AsString();
+		const std::string& from = req.at("from").AsString();
+		const std::string& to = req.at("to").AsString();
+
+		// Необязательное "alternatives" — сколько маршрутов вернуть сверх оптимального
+		size_t alternatives = 0;
+		if (auto it = req.find("alternatives"); it != req.end()) {
+			const int value = it->second.AsInt();
+			if (value < 0) {
+				return MakeErrorResponse(id, "invalid alternatives");
+			}
+			alternatives = std::min(static_cast<size_t>(value), ROUTE_MAX_ALTERNATIVES);
+		}
 
-		auto route = transport_router_.BuildRoute(from, to);
-		if (!route) {
+		// Повторные пары отдаём из кэша; версия маршрутизатора отсекает устаревшие ответы
+		RouteCacheKey key{ from, to, transport_router_.GetVersion(), alternatives };
+		auto cached = route_cache_.Get(key);
+		if (!cached) {
+			cached = alternatives == 0
+				? MakeRouteResponse(transport_router_.BuildRoute(from, to))
+				: MakeRouteResponse(transport_router_.BuildAlternativeRoutes(from, to, alternatives + 1));
+			route_cache_.Put(key, *cached);
+		}
+
+		if (!*cached) {
 			return MakeErrorResponse(id, "not found");
 		}
 
+		json::Dict response = **cached;
+		response.emplace("request_id", id);
+		return response;
+	}
+
+	RequestHandler::CachedRoute RequestHandler::MakeRouteResponse(
+		const std::optional<transport_router::RouteInfo>& route) {
+		if (!route) {
+			return nullptr;
+		}
+		return std::make_shared<const json::Dict>(MakeRouteDict(*route));
+	}
+
+	RequestHandler::CachedRoute RequestHandler::MakeRouteResponse(
+		const std::vector<transport_router::RouteInfo>& routes) {
+		if (routes.empty()) {
+			return nullptr;
+		}
+
+		json::Array alternatives;
+		alternatives.reserve(routes.size() - 1);
+		for (size_t i = 1; i < routes.size(); ++i) {
+			alternatives.emplace_back(MakeRouteDict(routes[i]));
+		}
+
+		json::Dict response = MakeRouteDict(routes.front());
+		response.emplace("alternatives", std::move(alternatives));
+		return std::make_shared<const json::Dict>(std::move(response));
+	}
+
+	json::Dict RequestHandler::MakeRouteDict(const transport_router::RouteInfo& route) {
 		json::Array items;
-		for (const auto& seg : route->segments) {
+		for (const auto& seg : route.segments) {
 			if (seg.type == transport_router::RouteSegment::Type::Wait) {
 				items.push_back(json::Builder{}
 					.StartDict()
 					.Key("type").Value("Wait")
-					.Key("stop_name").Value(seg.stop_name)
+					.Key("stop_name").Value(std::string(seg.stop_name))
 					.Key("time").Value(seg.time)
 					.EndDict()
 					.Build());
@@ -108,7 +194,7 @@ namespace request_handler {
 				items.push_back(json::Builder{}
 					.StartDict()
 					.Key("type").Value("Bus")
-					.Key("bus").Value(seg.bus_name)
+					.Key("bus").Value(std::string(seg.bus_name))
 					.Key("span_count").Value(static_cast<int>(seg.span_count))
 					.Key("time").Value(seg.time)
 					.EndDict()
@@ -118,13 +204,244 @@ namespace request_handler {
 
 		return json::Builder{}
 			.StartDict()
-			.Key("request_id").Value(id)
-			.Key("total_time").Value(route->total_time)
+			.Key("total_time").Value(route.total_time)
 			.Key("items").Value(std::move(items))
 			.EndDict()
 			.Build().AsDict();
 	}
 
+	json::Dict RequestHandler::ProcessRouteMatrixRequest(const json::Dict& req) const {
+		PROFILE_FUNCTION();
+		int id = req.at("id").AsInt();
+
+		// Собираем имена остановок; если "to" не задан — матрица квадратная по "from"
+		auto read_stops = [](const json::Node& node) {
+			std::vector<std::string_view> stops;
+			stops.reserve(node.AsArray().size());
+			for (const auto& stop_node : node.AsArray()) {
+				stops.push_back(stop_node.AsString());
+			}
+			return stops;
+		};
+
+		std::vector<std::string_view> from = read_stops(req.at("from"));
+		auto to_it = req.find("to");
+		std::vector<std::string_view> to = (to_it != req.end()) ? read_stops(to_it->second) : from;
+
+		auto matrix = transport_router_.ComputeTravelTimes(from, to);
+		if (!matrix) {
+			return MakeErrorResponse(id, "not found");
+		}
+
+		// Недостижимые пары выводим как null
+		json::Array times;
+		times.reserve(matrix->size());
+		for (const auto& row : *matrix) {
+			json::Array row_node;
+			row_node.reserve(row.size());
+			for (const auto& time : row) {
+				row_node.push_back(time ? json::Node(*time) : json::Node(nullptr));
+			}
+			times.push_back(std::move(row_node));
+		}
+
+		return json::Builder{}
+			.StartDict()
+			.Key("request_id").Value(id)
+			.Key("times").Value(std::move(times))
+			.EndDict()
+			.Build().AsDict();
+	}
+
+	json::Dict RequestHandler::ProcessIsochroneRequest(const json::Dict& req) const {
+		PROFILE_FUNCTION();
+		int id = req.at("id").AsInt();
+		const std::string& from = req.at("from").AsString();
+		double max_time = req.at("max_time").AsDouble();
+
+		// По умолчанию возвращаем только имена; времена — по флагу "with_times"
+		auto with_times_it = req.find("with_times");
+		bool with_times = with_times_it != req.end() && with_times_it->second.AsBool();
+
+		auto reachable = transport_router_.ComputeIsochrone(from, max_time);
+		if (!reachable) {
+			return MakeErrorResponse(id, "not found");
+		}
+
+		json::Array stops;
+		stops.reserve(reachable->size());
+		for (const auto& [stop, time] : *reachable) {
+			if (with_times) {
+				stops.push_back(json::Builder{}
+					.StartDict()
+					.Key("stop_name").Value(std::string(stop->name))
+					.Key("time").Value(time)
+					.EndDict()
+					.Build());
+			}
+			else {
+				stops.push_back(json::Node(std::string(stop->name)));
+			}
+		}
+
+		return json::Builder{}
+			.StartDict()
+			.Key("request_id").Value(id)
+			.Key("stops").Value(std::move(stops))
+			.EndDict()
+			.Build().AsDict();
+	}
+
+	json::Dict RequestHandler::ProcessStopSearchRequest(const json::Dict& req) const {
+		PROFILE_FUNCTION();
+		int id = req.at("id").AsInt();
+		const std::string& query = req.at("query").AsString();
+
+		// Необязательные "limit" и "max_distance"; отрицательные значения — ошибка запроса
+		auto get_count = [&req](const std::string& key, size_t default_value) -> std::optional<size_t> {
+			auto it = req.find(key);
+			if (it == req.end()) {
+				return default_value;
+			}
+			const int value = it->second.AsInt();
+			return value < 0 ? std::nullopt : std::optional<size_t>(value);
+		};
+		const auto limit = get_count("limit", STOP_SEARCH_DEFAULT_LIMIT);
+		const auto max_distance = get_count("max_distance", trans_cat::StopNameIndex::DefaultMaxDistance(query));
+		if (!limit || !max_distance) {
+			return MakeErrorResponse(id, "invalid limit or max_distance");
+		}
+
+		auto match_kind = [](trans_cat::StopMatch::Kind kind) {
+			switch (kind) {
+			case trans_cat::StopMatch::Kind::Exact: return "exact"s;
+			case trans_cat::StopMatch::Kind::Prefix: return "prefix"s;
+			case trans_cat::StopMatch::Kind::Fuzzy: return "fuzzy"s;
+			}
+			return ""s;
+		};
+
+		json::Array stops;
+		for (const trans_cat::StopMatch& match :
+			catalogue_.SearchStops(query, std::min(*limit, STOP_SEARCH_MAX_LIMIT), *max_distance)) {
+			stops.push_back(json::Builder{}
+				.StartDict()
+				.Key("name").Value(std::string(match.stop->name))
+				.Key("match").Value(match_kind(match.kind))
+				.Key("distance").Value(static_cast<int>(match.distance))
+				.EndDict()
+				.Build());
+		}
+
+		return json::Builder{}
+			.StartDict()
+			.Key("request_id").Value(id)
+			.Key("stops").Value(std::move(stops))
+			.EndDict()
+			.Build().AsDict();
+	}
+
+	json::Dict RequestHandler::ProcessDiagnosticsRequest(const json::Dict& req) const {
+		int id = req.at("id").AsInt();
+		const auto routing = transport_router_.GetDiagnostics();
+		const auto cache_stats = GetRouteCacheStats();
+
+		// int в json::Node 32-битный: объёмы памяти — в мегабайтах, счётчики — числами double
+		// (счётчики долгоживущего сервера переходят 2^31; double точен до 2^53)
+		auto to_mb = [](size_t bytes) {
+			return static_cast<double>(bytes) / (1024.0 * 1024.0);
+		};
+		auto to_number = [](uint64_t value) {
+			return static_cast<double>(value);
+		};
+
+		return json::Builder{}
+			.StartDict()
+			.Key("request_id").Value(id)
+			.Key("routing").StartDict()
+				.Key("strategy").Value(std::string(transport_router::ToString(routing.strategy)))
+				.Key("vertex_count").Value(to_number(routing.vertex_count))
+				.Key("edge_count").Value(to_number(routing.edge_count))
+				.Key("graph_mb").Value(to_mb(routing.graph_bytes))
+				.Key("all_pairs_mb").Value(to_mb(routing.all_pairs_bytes))
+				.Key("per_query_mb").Value(to_mb(routing.per_query_bytes))
+				.Key("landmark_count").Value(to_number(routing.landmark_count))
+				.Key("landmarks_mb").Value(to_mb(routing.landmark_bytes))
+				.Key("memory_limit_mb").Value(to_mb(routing.memory_limit_bytes))
+			.EndDict()
+			.Key("route_cache").StartDict()
+				.Key("hits").Value(to_number(cache_stats.hits))
+				.Key("misses").Value(to_number(cache_stats.misses))
+				.Key("evictions").Value(to_number(cache_stats.evictions))
+				.Key("size").Value(to_number(cache_stats.size))
+				.Key("capacity").Value(to_number(cache_stats.capacity))
+			.EndDict()
+			.EndDict()
+			.Build().AsDict();
+	}
+
+	json::Dict RequestHandler::ProcessStatsRequest(const json::Dict& req) const {
+		int id = req.at("id").AsInt();
+		const transport_router::RoutingStats* stats = transport_router_.GetStats();
+		if (!stats) {
+			return json::Builder{}
+				.StartDict()
+				.Key("request_id").Value(id)
+				.Key("enabled").Value(false)
+				.EndDict()
+				.Build().AsDict();
+		}
+
+		// Счётчики — double: суммы быстро выходят за 32-битный int в json::Node
+		auto to_number = [](uint64_t value) {
+			return static_cast<double>(value);
+		};
+
+		json::Dict metrics;
+		for (size_t i = 0; i < static_cast<size_t>(transport_router::QueryMetric::Count); ++i) {
+			const auto metric = static_cast<transport_router::QueryMetric>(i);
+			const auto histogram = stats->GetHistogram(metric);
+			metrics.emplace(std::string(transport_router::ToString(metric)), json::Builder{}
+				.StartDict()
+				.Key("total").Value(to_number(histogram.total))
+				.Key("mean").Value(to_number(histogram.Mean()))
+				.Key("p50").Value(to_number(histogram.Percentile(0.5)))
+				.Key("p90").Value(to_number(histogram.Percentile(0.9)))
+				.Key("p99").Value(to_number(histogram.Percentile(0.99)))
+				.Key("max").Value(to_number(histogram.max))
+				.EndDict()
+				.Build());
+		}
+
+		json::Array slowest;
+		for (const auto& slow : stats->GetSlowest()) {
+			slowest.push_back(json::Builder{}
+				.StartDict()
+				.Key("from").Value(slow.from)
+				.Key("to").Value(slow.to)
+				.Key("time_ns").Value(to_number(slow.stats.time_ns))
+				.Key("settled").Value(to_number(slow.stats.settled))
+				.Key("relaxed").Value(to_number(slow.stats.relaxed))
+				.Key("heap_pushes").Value(to_number(slow.stats.heap_pushes))
+				.Key("heap_pops").Value(to_number(slow.stats.heap_pops))
+				.Key("path_edges").Value(to_number(slow.stats.path_edges))
+				.Key("searches").Value(to_number(slow.stats.searches))
+				.Key("batch_size").Value(to_number(slow.stats.batch_size))
+				.EndDict()
+				.Build());
+		}
+
+		return json::Builder{}
+			.StartDict()
+			.Key("request_id").Value(id)
+			.Key("enabled").Value(true)
+			.Key("queries").Value(to_number(stats->GetQueryCount()))
+			.Key("metrics").Value(std::move(metrics))
+			.Key("slowest").Value(std::move(slowest))
+			.EndDict()
+			.Build().AsDict();
+	}
+
 	json::Dict RequestHandler::MakeErrorResponse(int id, std::string_view message) {
 		return json::Builder{}
 			.StartDict()
@@ -136,6 +453,7 @@ namespace request_handler {
 
 	RequestHandler RequestHandler::Create(const trans_cat::TransportCatalogue& catalogue,
 		const json::Document& input) {
+		PROFILE_FUNCTION();
 		const auto& root = input.GetRoot().AsDict();
 
 		std::optional<renderer::MapRenderer> renderer = std::nullopt;
@@ -158,10 +476,73 @@ namespace request_handler {
 			throw std::logic_error("No stat_requests provided");
 		}
 
-		auto responses = processor_.Process(*stat_requests_);
+		std::vector<json::Dict> responses;
+		{
+			PROFILE_SCOPE("ProcessRequests: handle");
+			PrefetchRoutes(*stat_requests_);
+			responses = processor_.Process(*stat_requests_);
+		}
+		PROFILE_SCOPE("ProcessRequests: print");
 		processor_.Print(responses, out);
 	}
 
+	std::vector<json::Dict> RequestHandler::ProcessRequests(const json::Array& requests) const {
+		PrefetchRoutes(requests);
+		return processor_.Process(requests);
+	}
+
+	void RequestHandler::PrefetchRoutes(const json::Array& requests) const {
+		PROFILE_FUNCTION();
+		// Таблица всех пар отвечает на каждый запрос без поиска — группировать нечего
+		if (transport_router_.GetDiagnostics().strategy == transport_router::RoutingStrategy::AllPairs) {
+			return;
+		}
+
+		// Различные пары, которых ещё нет в кэше; некорректные запросы пропускаем —
+		// ошибку по ним вернёт обычная обработка; запросы с альтернативами строятся по одному
+		const uint64_t version = transport_router_.GetVersion();
+		std::unordered_set<RouteCacheKey, RouteCacheKeyHash> keys;
+		std::unordered_map<std::string_view, size_t> origin_pair_count;
+		for (const auto& node : requests) {
+			if (!node.IsDict()) {
+				continue;
+			}
+			const auto& req = node.AsDict();
+			auto type = req.find("type");
+			auto from = req.find("from");
+			auto to = req.find("to");
+			if (type == req.end() || !type->second.IsString() || type->second.AsString() != "Route"
+				|| req.count("alternatives") || from == req.end() || !from->second.IsString() || to == req.end() || !to->second.IsString()) {
+				continue;
+			}
+
+			RouteCacheKey key{ from->second.AsString(), to->second.AsString(), version };
+			if (!route_cache_.Contains(key) && keys.insert(std::move(key)).second) {
+				++origin_pair_count[from->second.AsString()];
+			}
+		}
+
+		// Одиночную пару обычная обработка построит не дороже; остальные — не больше
+		// половины кэша, чтобы построенные ответы не вытеснили друг друга до использования
+		std::vector<const RouteCacheKey*> batch;
+		std::vector<transport_router::TransportRouter::StopPair> pairs;
+		for (const RouteCacheKey& key : keys) {
+			if (origin_pair_count.at(key.from) < 2 || batch.size() >= ROUTE_CACHE_CAPACITY / 2) {
+				continue;
+			}
+			batch.push_back(&key);
+			pairs.emplace_back(key.from, key.to);
+		}
+		if (pairs.empty()) {
+			return;
+		}
+
+		auto routes = transport_router_.BuildRoutes(pairs);
+		for (size_t i = 0; i < batch.size(); ++i) {
+			route_cache_.Put(*batch[i], MakeRouteResponse(routes[i]));
+		}
+	}
+
 	std::optional<RouteStat> RequestHandler::GetBusStat(const std::string& bus_name) const {
 		auto stat = catalogue_.GetRouteStat(bus_name);
 		if (!stat) {
@@ -177,6 +558,14 @@ namespace request_handler {
 		};
 	}
 
+	cache::CacheStats RequestHandler::GetRouteCacheStats() const {
+		return route_cache_.GetStats();
+	}
+
+	const transport_router::RoutingStats* RequestHandler::GetRoutingStats() const {
+		return transport_router_.GetStats();
+	}
+
 	std::optional<StopStat> RequestHandler::GetStopStat(const std::string& stop_name) const {
 		const trans_cat::Stop* stop = catalogue_.FindStop(stop_name);
 		if (!stop) {
@@ -186,9 +575,10 @@ namespace request_handler {
 		StopStat result;
 		result.name = stop_name;
 
-		const auto& routes = catalogue_.GetBusesByStop(stop);
+		const auto routes = catalogue_.GetBusesByStop(stop);
+		result.bus_names.reserve(routes.size());
 		for (const trans_cat::Route* route : routes) {
-			result.bus_names.push_back(route->name);
+			result.bus_names.emplace_back(route->name);
 		}
 		return result;
 	}
@@ -5,11 +5,14 @@
 #include "map_renderer.h"
 #include "json_reader.h"
 #include "transport_router.h"
+#include "lru_cache.h"
 
 #include <optional>
 #include <string>
 #include <map>
+#include <memory>
 #include <functional>
+#include <mutex>
 
 /**
  * @brief Модуль обработки запросов к транспортному справочнику.
@@ -39,6 +42,21 @@ namespace request_handler {
 		std::vector<std::string> bus_names;	///< Маршруты через остановку
 	};
 
+	/// Ключ кэша ответов на Route: маршрут зависит от пары остановок, версии маршрутизатора и числа альтернатив
+	struct RouteCacheKey {
+		std::string from;
+		std::string to;
+		uint64_t router_version = 0;
+		size_t alternatives = 0;
+
+		bool operator==(const RouteCacheKey& other) const = default;
+	};
+
+	/// Хэшер ключа кэша маршрутов
+	struct RouteCacheKeyHash {
+		size_t operator()(const RouteCacheKey& key) const;
+	};
+
 	/**
 	 * @brief Фасад для обработки запросов к транспортному справочнику.
 	 *
@@ -46,6 +64,12 @@ namespace request_handler {
 	 * - "Bus" → статистика маршрута
 	 * - "Stop" → статистика остановки
 	 * - "Map" → SVG-карта
+	 * - "Route" → оптимальный маршрут между остановками (и, по запросу, альтернативы)
+	 * - "RouteMatrix" → матрица времён в пути между наборами остановок
+	 * - "Isochrone" → остановки, достижимые за заданное время
+	 * - "Diagnostics" → стратегия маршрутизации, оценки памяти и статистика кэша
+	 * - "StopSearch" → остановки по началу имени или с опечатками
+	 * - "Stats" → статистика работы маршрутизатора по запросам (если включена)
 	 *
 	 * Использует RequestProcessor для обработки запросов.
 	 */
@@ -58,6 +82,10 @@ namespace request_handler {
 		// Обрабатывает запросы и выводит результат в поток.
 		void ProcessRequests(std::ostream& out) const;
 
+		// Обрабатывает произвольный набор запросов (например, поступивших после загрузки).
+		// Потокобезопасен, пока каталог не изменяется.
+		std::vector<json::Dict> ProcessRequests(const json::Array& requests) const;
+
 		// Получает статистику по маршруту.
 		// nullopt, если маршрут не найден
 		std::optional<RouteStat> GetBusStat(const std::string& bus_name) const;
@@ -66,6 +94,12 @@ namespace request_handler {
 		// nullopt, если остановка не найдена
 		std::optional<StopStat> GetStopStat(const std::string& stop_name) const;
 
+		// Возвращает счётчики попаданий/промахов кэша ответов на Route.
+		cache::CacheStats GetRouteCacheStats() const;
+
+		// Статистика запросов маршрутизатора; nullptr, если не включена в routing_settings.
+		const transport_router::RoutingStats* GetRoutingStats() const;
+
 	private:
 		/// Функция-обработчик запроса
 		using Handler = std::function<json::Dict(const json::Dict&)>;
@@ -82,6 +116,28 @@ namespace request_handler {
 		json::Dict ProcessMapRequest(const json::Dict& req) const;
 		json::Dict ProcessRouteRequest(const json::Dict& req) const;
 
+		/// Сериализованный ответ на Route без request_id; nullptr — маршрут не найден
+		using CachedRoute = std::shared_ptr<const json::Dict>;
+
+		// Строит ответ на Route (без request_id) — то, что попадает в кэш
+		static CachedRoute MakeRouteResponse(const std::optional<transport_router::RouteInfo>& route);
+
+		// Ответ на Route с альтернативами: первый маршрут — как в обычном ответе,
+		// остальные — в массиве "alternatives"
+		static CachedRoute MakeRouteResponse(const std::vector<transport_router::RouteInfo>& routes);
+
+		// Маршрут в JSON: "total_time" и "items"
+		static json::Dict MakeRouteDict(const transport_router::RouteInfo& route);
+
+		// Заранее строит пакетом маршруты запросов Route, у которых общая остановка
+		// отправления, и кладёт ответы в кэш (один поиск на остановку отправления)
+		void PrefetchRoutes(const json::Array& requests) const;
+		json::Dict ProcessRouteMatrixRequest(const json::Dict& req) const;
+		json::Dict ProcessIsochroneRequest(const json::Dict& req) const;
+		json::Dict ProcessDiagnosticsRequest(const json::Dict& req) const;
+		json::Dict ProcessStopSearchRequest(const json::Dict& req) const;
+		json::Dict ProcessStatsRequest(const json::Dict& req) const;
+
 		// Универсальный генератор ответа об ошибке
 		static json::Dict MakeErrorResponse(int id, std::string_view message);
 
@@ -130,6 +186,29 @@ namespace request_handler {
 		RequestProcessor processor_;  // диспетчер запросов
 		transport_router::RoutingSettings routing_settings_;
 		transport_router::TransportRouter transport_router_;
+
+		// Ёмкость кэша ответов на Route (записей)
+		static constexpr size_t ROUTE_CACHE_CAPACITY = 1 << 14;
+
+		// Число кандидатов StopSearch: по умолчанию и наибольшее
+		static constexpr size_t STOP_SEARCH_DEFAULT_LIMIT = 10;
+		static constexpr size_t STOP_SEARCH_MAX_LIMIT = 100;
+
+		// Наибольшее число альтернатив в ответе на Route (сверх оптимального маршрута)
+		static constexpr size_t ROUTE_MAX_ALTERNATIVES = 4;
+
+		// Кэш ответов на Route: одни и те же пары остановок запрашиваются многократно
+		mutable cache::ShardedLruCache<RouteCacheKey, CachedRoute, RouteCacheKeyHash> route_cache_{ ROUTE_CACHE_CAPACITY };
+
+		// Отрисованная карта и версия каталога (TransportCatalogue::GetChangeVersion), по которой она построена
+		struct CachedMap {
+			uint64_t catalogue_version = 0;
+			std::shared_ptr<const std::string> svg;
+		};
+
+		// Кэш карты: перерисовывается при первом запросе Map после изменения каталога
+		mutable std::mutex map_mutex_;
+		mutable CachedMap map_cache_;
 	};
 
 } // namespace request_handler
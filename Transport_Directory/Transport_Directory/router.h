@@ -1,11 +1,15 @@
 #pragma once
 
 #include "graph.h"
+#include "dijkstra.h"
+#include "parallel.h"
 
 #include <algorithm>
 #include <cassert>
 #include <cstdint>
 #include <iterator>
+#include <limits>
+#include <numeric>
 #include <optional>
 #include <stdexcept>
 #include <unordered_map>
@@ -19,7 +23,8 @@
  * Реализует класс Router, который позволяет находить кратчайшие пути
  * между парами вершин в ориентированном взвешенном графе.
  *
- * Используется алгоритм Флойда-Уоршелла с оптимизацией восстановления путей.
+ * Используется блочный многопоточный алгоритм Флойда-Уоршелла
+ * над плоскими матрицами весов и последних рёбер.
  * Подходит для графов с неотрицательными весами рёбер.
  *
  * @tparam Weight — тип веса рёбер (должен поддерживать операции +, <, =)
@@ -33,9 +38,10 @@ namespace graph {
 	 * Вычисляет кратчайшие пути между всеми парами вершин при создании.
 	 * Поддерживает запросы на построение маршрута между двумя вершинами.
 	 *
-	 * @note Используется алгоритм Флойда-Уоршелла.
+	 * @note Используется алгоритм Флойда-Уоршелла (блочный, блоки одного шага — параллельно).
 	 * @note Граф должен иметь неотрицательные веса рёбер.
 	 * @note Сложность построения: O(V³), запроса: O(L), где L — длина маршрута.
+	 * @note Память: 2·V² значений (вес и ID ребра на каждую пару вершин).
 	 */
 	template <typename Weight>
 	class Router {
@@ -68,21 +74,46 @@ namespace graph {
 		 */
 		std::optional<RouteInfo> BuildRoute(VertexId from, VertexId to) const;
 
-	private:
 		/**
-		 * @brief Внутренние данные для построения маршрута.
+		 * @brief Обновляет таблицу кратчайших путей после изменения графа.
+		 *
+		 * Вместо полного пересчёта за O(V³):
+		 * - для новых вершин графа расширяет таблицу;
+		 * - строки, пути в которых проходили через ухудшенные рёбра, пересчитывает
+		 *   поиском из одной вершины (ShortestPathTree), остальные строки не трогает;
+		 * - для добавленных и подешевевших рёбер выполняет релаксацию через ребро.
+		 *
+		 * @param improved_edges Рёбра, добавленные в граф или ставшие легче
+		 * @param worsened_edges Рёбра, исключённые из графа или ставшие тяжелее
+		 * @throw std::domain_error, если вес улучшенного ребра отрицательный
 		 *
-		 * Хранит:
-		 * - weight: суммарный вес кратчайшего пути
-		 * - prev_edge: ID последнего ребра в кратчайшем пути (для восстановления)
+		 * @note Сложность: O(V²) на проверку строк, O((V + E) log V) на каждую
+		 *       пересчитанную строку и до O(V²) на каждое улучшенное ребро.
 		 */
-		struct RouteInternalData {
-			Weight weight;
-			std::optional<EdgeId> prev_edge;
-		};
+		void Update(const std::vector<EdgeId>& improved_edges, const std::vector<EdgeId>& worsened_edges);
 
-		/// Двумерный массив: routes_internal_data_[from][to] — данные о пути
-		using RoutesInternalData = std::vector<std::vector<std::optional<RouteInternalData>>>;
+		/**
+		 * @brief Оценивает объём таблицы путей для графа с заданным числом вершин.
+		 * @return Байты под матрицы весов и последних рёбер (без учёта самого графа)
+		 */
+		static size_t EstimateMemory(size_t vertex_count);
+
+	private:
+		/// Вес недостижимой пары (бесконечность для вещественных весов)
+		static constexpr Weight UNREACHABLE = std::numeric_limits<Weight>::has_infinity
+			? std::numeric_limits<Weight>::infinity()
+			: std::numeric_limits<Weight>::max();
+
+		/// Отсутствие последнего ребра (путь из вершины в себя или недостижимая пара)
+		static constexpr EdgeId NO_EDGE = std::numeric_limits<EdgeId>::max();
+
+		/// Сторона квадратного блока матриц: веса и рёбра блока — 256 КБ, три блока шага помещаются в L2/L3
+		static constexpr size_t BLOCK_SIZE = 128;
+
+		/// Индекс ячейки (from, to) в матрицах, хранящихся построчно
+		size_t Index(VertexId from, VertexId to) const {
+			return from * vertex_count_ + to;
+		}
 
 		/**
 		 * @brief Инициализирует начальные данные для алгоритма.
@@ -95,47 +126,64 @@ namespace graph {
 		void InitializeRoutesInternalData(const Graph& graph);
 
 		/**
-		 * @brief Пытается улучшить путь из vertex_from в vertex_to через вершину.
+		 * @brief Блочный алгоритм Флойда-Уоршелла.
 		 *
-		 * Если путь vertex_from → vertex_through → vertex_to короче текущего,
-		 * обновляет маршрут и сохраняет предыдущее ребро.
+		 * Для каждого блока промежуточных вершин K:
+		 * 1) диагональный блок (K, K);
+		 * 2) блоки строки (K, *) и столбца (*, K) — параллельно;
+		 * 3) все остальные блоки — параллельно.
+		 * Внутри шага блоки не пишут в ячейки, которые читают другие блоки этого шага.
 		 */
-		void RelaxRoute(VertexId vertex_from, VertexId vertex_to,
-			const RouteInternalData& route_from,
-			const RouteInternalData& route_to);
+		void ComputeAllRoutes();
 
 		/**
-		 * @brief Обновляет все кратчайшие пути, проходящие через вершину vertex_through.
+		 * @brief Релаксирует блок (rows, cols) через промежуточные вершины блока through.
 		 *
-		 * Реализует основной шаг алгоритма Флойда-Уоршелла.
+		 * Основной шаг алгоритма Флойда-Уоршелла, ограниченный тремя блоками матрицы.
 		 */
-		void RelaxRoutesInternalDataThroughVertex(size_t vertex_count, VertexId vertex_through);
+		void RelaxBlock(size_t rows_block, size_t cols_block, size_t through_block);
+
+		/// Расширяет матрицы под вершины, добавленные в граф после их построения
+		void ResizeRoutesInternalData();
+
+		/// Пересчитывает строку матриц (все пути из vertex_from) поиском Дейкстры
+		void RecomputeRoutesFrom(VertexId vertex_from);
+
+		/// Улучшает пути, которые выгоднее проложить через ребро edge_id
+		void RelaxRoutesThroughEdge(EdgeId edge_id);
 
 		static constexpr Weight ZERO_WEIGHT{};  ///< Нулевой вес (для начальной инициализации)
 
 		const Graph& graph_;                    ///< Граф, для которого строим маршруты
-		RoutesInternalData routes_internal_data_; ///< Таблица кратчайших путей
+		size_t vertex_count_ = 0;               ///< Число вершин (сторона матриц)
+
+		// Таблица кратчайших путей — две плоские матрицы V×V, хранящиеся построчно:
+		// 16 байт на пару вершин вместо std::optional от пары с вложенным std::optional
+		std::vector<Weight> weights_;           ///< Вес кратчайшего пути (UNREACHABLE — пути нет)
+		std::vector<EdgeId> prev_edges_;        ///< Последнее ребро пути (NO_EDGE — пути нет или from == to)
 	};
 
 	// ====================================================
 	// Реализация методов
 	// ====================================================
 
+	template <typename Weight>
+	size_t Router<Weight>::EstimateMemory(size_t vertex_count) {
+		return vertex_count * vertex_count * (sizeof(Weight) + sizeof(EdgeId));
+	}
+
 	/**
 	 * Конструктор: инициализирует данные и запускает алгоритм Флойда-Уоршелла.
 	 */
 	template <typename Weight>
 	Router<Weight>::Router(const Graph& graph)
 		: graph_(graph)
-		, routes_internal_data_(graph.GetVertexCount(),
-			std::vector<std::optional<RouteInternalData>>(graph.GetVertexCount()))
+		, vertex_count_(graph.GetVertexCount())
+		, weights_(vertex_count_ * vertex_count_, UNREACHABLE)
+		, prev_edges_(vertex_count_ * vertex_count_, NO_EDGE)
 	{
 		InitializeRoutesInternalData(graph);
-
-		const size_t vertex_count = graph.GetVertexCount();
-		for (VertexId vertex_through = 0; vertex_through < vertex_count; ++vertex_through) {
-			RelaxRoutesInternalDataThroughVertex(vertex_count, vertex_through);
-		}
+		ComputeAllRoutes();
 	}
 
 	/**
@@ -145,10 +193,9 @@ namespace graph {
 	 */
 	template <typename Weight>
 	void Router<Weight>::InitializeRoutesInternalData(const Graph& graph) {
-		const size_t vertex_count = graph.GetVertexCount();
-		for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
+		for (VertexId vertex = 0; vertex < vertex_count_; ++vertex) {
 			// Путь из вершины в себя
-			routes_internal_data_[vertex][vertex] = RouteInternalData{ ZERO_WEIGHT, std::nullopt };
+			weights_[Index(vertex, vertex)] = ZERO_WEIGHT;
 
 			// Прямые рёбра
 			for (const EdgeId edge_id : graph.GetIncidentEdges(vertex)) {
@@ -156,41 +203,220 @@ namespace graph {
 				if (edge.weight < ZERO_WEIGHT) {
 					throw std::domain_error("Edges' weights should be non-negative");
 				}
-				auto& route_internal_data = routes_internal_data_[vertex][edge.to];
-				if (!route_internal_data || route_internal_data->weight > edge.weight) {
-					route_internal_data = RouteInternalData{ edge.weight, edge_id };
+				const size_t index = Index(vertex, edge.to);
+				if (weights_[index] == UNREACHABLE || weights_[index] > edge.weight) {
+					weights_[index] = edge.weight;
+					prev_edges_[index] = edge_id;
+				}
+			}
+		}
+	}
+
+	template <typename Weight>
+	void Router<Weight>::ComputeAllRoutes() {
+		const size_t block_count = (vertex_count_ + BLOCK_SIZE - 1) / BLOCK_SIZE;
+
+		std::vector<size_t> blocks(block_count);
+		std::iota(blocks.begin(), blocks.end(), size_t{ 0 });
+
+		std::vector<std::pair<size_t, size_t>> other_blocks;
+		other_blocks.reserve(block_count * block_count);
+
+		for (size_t through = 0; through < block_count; ++through) {
+			// 1) Диагональный блок зависит только от себя
+			RelaxBlock(through, through, through);
+
+			// 2) Строка и столбец блоков зависят только от диагонального
+			parallel::ForEach(blocks.begin(), blocks.end(), [this, through](size_t block) {
+				if (block != through) {
+					RelaxBlock(through, block, through);
+					RelaxBlock(block, through, through);
+				}
+			});
+
+			// 3) Остальные блоки зависят только от строки и столбца
+			other_blocks.clear();
+			for (size_t rows = 0; rows < block_count; ++rows) {
+				for (size_t cols = 0; cols < block_count; ++cols) {
+					if (rows != through && cols != through) {
+						other_blocks.emplace_back(rows, cols);
+					}
+				}
+			}
+			parallel::ForEach(other_blocks.begin(), other_blocks.end(),
+				[this, through](const std::pair<size_t, size_t>& block) {
+					RelaxBlock(block.first, block.second, through);
+				});
+		}
+	}
+
+	/**
+	 * Путь from → to через вершину through улучшается, если он короче текущего;
+	 * последнее ребро берётся из пути through → to.
+	 */
+	template <typename Weight>
+	void Router<Weight>::RelaxBlock(size_t rows_block, size_t cols_block, size_t through_block) {
+		const size_t row_begin = rows_block * BLOCK_SIZE;
+		const size_t row_end = std::min(row_begin + BLOCK_SIZE, vertex_count_);
+		const size_t col_begin = cols_block * BLOCK_SIZE;
+		const size_t col_end = std::min(col_begin + BLOCK_SIZE, vertex_count_);
+		const size_t through_begin = through_block * BLOCK_SIZE;
+		const size_t through_end = std::min(through_begin + BLOCK_SIZE, vertex_count_);
+
+		for (VertexId vertex_through = through_begin; vertex_through < through_end; ++vertex_through) {
+			const Weight* weights_through = &weights_[Index(vertex_through, 0)];
+			const EdgeId* prev_edges_through = &prev_edges_[Index(vertex_through, 0)];
+
+			for (VertexId vertex_from = row_begin; vertex_from < row_end; ++vertex_from) {
+				const Weight weight_from = weights_[Index(vertex_from, vertex_through)];
+				if (weight_from == UNREACHABLE) {
+					continue;
+				}
+				Weight* weights_row = &weights_[Index(vertex_from, 0)];
+				EdgeId* prev_edges_row = &prev_edges_[Index(vertex_from, 0)];
+
+				// Если vertex_to == vertex_through, кандидат равен текущему весу и не строго лучше,
+				// поэтому последнее ребро всегда берётся из строки vertex_through
+				for (VertexId vertex_to = col_begin; vertex_to < col_end; ++vertex_to) {
+					if constexpr (!std::numeric_limits<Weight>::has_infinity) {
+						// Без бесконечности сумма с UNREACHABLE переполнится — пропускаем явно
+						if (weights_through[vertex_to] == UNREACHABLE) {
+							continue;
+						}
+					}
+
+					const Weight candidate_weight = weight_from + weights_through[vertex_to];
+					if (candidate_weight < weights_row[vertex_to]) {
+						weights_row[vertex_to] = candidate_weight;
+						prev_edges_row[vertex_to] = prev_edges_through[vertex_to];
+					}
 				}
 			}
 		}
 	}
 
 	/**
-	 * Пытается улучшить путь vertex_from → vertex_to через вершину vertex_through.
+	 * Инкрементальное обновление: сначала пересчитываются затронутые строки,
+	 * затем выполняется релаксация через улучшенные рёбра.
 	 */
 	template <typename Weight>
-	void Router<Weight>::RelaxRoute(VertexId vertex_from, VertexId vertex_to,
-		const RouteInternalData& route_from,
-		const RouteInternalData& route_to) {
-		auto& route_relaxing = routes_internal_data_[vertex_from][vertex_to];
-		const Weight candidate_weight = route_from.weight + route_to.weight;
-		if (!route_relaxing || candidate_weight < route_relaxing->weight) {
-			route_relaxing = { candidate_weight,
-							  route_to.prev_edge ? route_to.prev_edge : route_from.prev_edge };
+	void Router<Weight>::Update(const std::vector<EdgeId>& improved_edges,
+		const std::vector<EdgeId>& worsened_edges) {
+		ResizeRoutesInternalData();
+
+		if (!worsened_edges.empty()) {
+			std::vector<bool> is_worsened(graph_.GetEdgeCount(), false);
+			for (const EdgeId edge_id : worsened_edges) {
+				is_worsened[edge_id] = true;
+			}
+
+			// Строка затронута, если хотя бы один сохранённый путь идёт через ухудшенное ребро:
+			// такой путь восстанавливается по цепочке prev_edge этой же строки
+			std::vector<VertexId> affected_rows;
+			for (VertexId vertex_from = 0; vertex_from < vertex_count_; ++vertex_from) {
+				const auto row_begin = prev_edges_.begin() + Index(vertex_from, 0);
+				const bool affected = std::any_of(row_begin, row_begin + vertex_count_,
+					[&is_worsened](EdgeId prev_edge) {
+						return prev_edge != NO_EDGE && is_worsened[prev_edge];
+					});
+				if (affected) {
+					affected_rows.push_back(vertex_from);
+				}
+			}
+
+			// Строки независимы — пересчитываем их параллельно
+			parallel::ForEach(affected_rows.begin(), affected_rows.end(),
+				[this](VertexId vertex_from) {
+					RecomputeRoutesFrom(vertex_from);
+				});
+		}
+
+		for (const EdgeId edge_id : improved_edges) {
+			RelaxRoutesThroughEdge(edge_id);
+		}
+	}
+
+	template <typename Weight>
+	void Router<Weight>::ResizeRoutesInternalData() {
+		const size_t old_count = vertex_count_;
+		const size_t vertex_count = graph_.GetVertexCount();
+		if (vertex_count <= old_count) {
+			return;
+		}
+
+		// Шаг строк меняется — переносим старые строки в новые матрицы
+		std::vector<Weight> weights(vertex_count * vertex_count, UNREACHABLE);
+		std::vector<EdgeId> prev_edges(vertex_count * vertex_count, NO_EDGE);
+		for (VertexId vertex_from = 0; vertex_from < old_count; ++vertex_from) {
+			std::copy_n(weights_.begin() + vertex_from * old_count, old_count,
+				weights.begin() + vertex_from * vertex_count);
+			std::copy_n(prev_edges_.begin() + vertex_from * old_count, old_count,
+				prev_edges.begin() + vertex_from * vertex_count);
+		}
+
+		weights_ = std::move(weights);
+		prev_edges_ = std::move(prev_edges);
+		vertex_count_ = vertex_count;
+
+		// Путь из новой вершины в себя
+		for (VertexId vertex = old_count; vertex < vertex_count; ++vertex) {
+			weights_[Index(vertex, vertex)] = ZERO_WEIGHT;
+		}
+	}
+
+	template <typename Weight>
+	void Router<Weight>::RecomputeRoutesFrom(VertexId vertex_from) {
+		const ShortestPathTree<Weight> tree(graph_, vertex_from);
+
+		for (VertexId vertex_to = 0; vertex_to < vertex_count_; ++vertex_to) {
+			const size_t index = Index(vertex_from, vertex_to);
+			if (const auto weight = tree.GetWeight(vertex_to)) {
+				weights_[index] = *weight;
+				prev_edges_[index] = tree.GetPrevEdge(vertex_to).value_or(NO_EDGE);
+			}
+			else {
+				weights_[index] = UNREACHABLE;
+				prev_edges_[index] = NO_EDGE;
+			}
 		}
 	}
 
 	/**
-	 * Обновляет все пути, проходящие через вершину vertex_through.
-	 * Основной шаг алгоритма Флойда-Уоршелла.
+	 * Для каждой строки: если ребро не улучшает путь до своего конца,
+	 * то не улучшает и пути, проходящие через него дальше — строку пропускаем.
 	 */
 	template <typename Weight>
-	void Router<Weight>::RelaxRoutesInternalDataThroughVertex(size_t vertex_count, VertexId vertex_through) {
-		for (VertexId vertex_from = 0; vertex_from < vertex_count; ++vertex_from) {
-			if (const auto& route_from = routes_internal_data_[vertex_from][vertex_through]) {
-				for (VertexId vertex_to = 0; vertex_to < vertex_count; ++vertex_to) {
-					if (const auto& route_to = routes_internal_data_[vertex_through][vertex_to]) {
-						RelaxRoute(vertex_from, vertex_to, *route_from, *route_to);
-					}
+	void Router<Weight>::RelaxRoutesThroughEdge(EdgeId edge_id) {
+		const auto& edge = graph_.GetEdge(edge_id);
+		if (edge.weight < ZERO_WEIGHT) {
+			throw std::domain_error("Edges' weights should be non-negative");
+		}
+
+		const Weight* weights_from_edge_end = &weights_[Index(edge.to, 0)];
+		const EdgeId* prev_edges_from_edge_end = &prev_edges_[Index(edge.to, 0)];
+
+		for (VertexId vertex_from = 0; vertex_from < vertex_count_; ++vertex_from) {
+			Weight* weights_row = &weights_[Index(vertex_from, 0)];
+			EdgeId* prev_edges_row = &prev_edges_[Index(vertex_from, 0)];
+			if (vertex_from == edge.to || weights_row[edge.from] == UNREACHABLE) {
+				continue;
+			}
+
+			const Weight weight_to_edge_end = weights_row[edge.from] + edge.weight;
+			if (weights_row[edge.to] != UNREACHABLE && !(weight_to_edge_end < weights_row[edge.to])) {
+				continue;
+			}
+
+			for (VertexId vertex_to = 0; vertex_to < vertex_count_; ++vertex_to) {
+				if (weights_from_edge_end[vertex_to] == UNREACHABLE) {
+					continue;
+				}
+				const Weight candidate_weight = weight_to_edge_end + weights_from_edge_end[vertex_to];
+				if (candidate_weight < weights_row[vertex_to]) {
+					weights_row[vertex_to] = candidate_weight;
+					prev_edges_row[vertex_to] = prev_edges_from_edge_end[vertex_to] != NO_EDGE
+						? prev_edges_from_edge_end[vertex_to]
+						: edge_id;
 				}
 			}
 		}
@@ -202,19 +428,23 @@ namespace graph {
 	 */
 	template <typename Weight>
 	std::optional<typename Router<Weight>::RouteInfo> Router<Weight>::BuildRoute(VertexId from, VertexId to) const {
-		const auto& route_internal_data = routes_internal_data_.at(from).at(to);
-		if (!route_internal_data) {
+		if (from >= vertex_count_ || to >= vertex_count_) {
+			throw std::out_of_range("Router: vertex id is out of range");
+		}
+
+		const size_t index = Index(from, to);
+		if (weights_[index] == UNREACHABLE) {
 			return std::nullopt;  // Путь не существует
 		}
 
-		const Weight weight = route_internal_data->weight;
+		const Weight weight = weights_[index];
 		std::vector<EdgeId> edges;
 
 		// Собираем рёбра, идя по цепочке prev_edge
-		for (std::optional<EdgeId> edge_id = route_internal_data->prev_edge;
-			edge_id;
-			edge_id = routes_internal_data_[from][graph_.GetEdge(*edge_id).from]->prev_edge) {
-			edges.push_back(*edge_id);
+		for (EdgeId edge_id = prev_edges_[index];
+			edge_id != NO_EDGE;
+			edge_id = prev_edges_[Index(from, graph_.GetEdge(edge_id).from)]) {
+			edges.push_back(edge_id);
 		}
 
 		// Рёбра собраны в обратном порядке — разворачиваем
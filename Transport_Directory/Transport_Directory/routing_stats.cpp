@@ -0,0 +1,153 @@
+#include "routing_stats.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <ostream>
+#include <sstream>
+
+namespace transport_router {
+
+    std::string_view ToString(QueryMetric metric) {
+        switch (metric) {
+        case QueryMetric::Settled:
+            return "settled";
+        case QueryMetric::Relaxed:
+            return "relaxed";
+        case QueryMetric::HeapPushes:
+            return "heap_pushes";
+        case QueryMetric::HeapPops:
+            return "heap_pops";
+        case QueryMetric::PathEdges:
+            return "path_edges";
+        case QueryMetric::Time:
+            return "time_ns";
+        case QueryMetric::Count:
+            break;
+        }
+        return "unknown";
+    }
+
+    void RoutingStats::Histogram::Add(uint64_t value) {
+        count.fetch_add(1, std::memory_order_relaxed);
+        total.fetch_add(value, std::memory_order_relaxed);
+        buckets[profiler::ScopeStats::BucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+
+        // Минимум и максимум: CAS только если значение их действительно меняет
+        for (uint64_t current = min.load(std::memory_order_relaxed);
+            value < current && !min.compare_exchange_weak(current, value, std::memory_order_relaxed);) {
+        }
+        for (uint64_t current = max.load(std::memory_order_relaxed);
+            value > current && !max.compare_exchange_weak(current, value, std::memory_order_relaxed);) {
+        }
+    }
+
+    uint64_t MetricSnapshot::Mean() const {
+        return count ? total / count : 0;
+    }
+
+    uint64_t MetricSnapshot::Percentile(double q) const {
+        if (count == 0) {
+            return 0;
+        }
+        const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(q * static_cast<double>(count) + 0.5));
+        uint64_t seen = 0;
+        for (size_t i = 0; i < buckets.size(); ++i) {
+            seen += buckets[i];
+            if (seen >= rank) {
+                const uint64_t middle = (profiler::ScopeStats::BucketLowerBound(i)
+                    + profiler::ScopeStats::BucketLowerBound(i + 1)) / 2;
+                return std::clamp(middle, min, max);
+            }
+        }
+        return max;
+    }
+
+    MetricSnapshot RoutingStats::Histogram::Snapshot() const {
+        MetricSnapshot snapshot;
+        snapshot.count = count.load(std::memory_order_relaxed);
+        snapshot.total = total.load(std::memory_order_relaxed);
+        snapshot.min = min.load(std::memory_order_relaxed);
+        snapshot.max = max.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < buckets.size(); ++i) {
+            snapshot.buckets[i] = buckets[i].load(std::memory_order_relaxed);
+        }
+        return snapshot;
+    }
+
+    void RoutingStats::Record(std::string_view from, std::string_view to, const QueryStats& query) {
+        const std::array<uint64_t, METRIC_COUNT> values{
+            query.settled, query.relaxed, query.heap_pushes, query.heap_pops, query.path_edges, query.time_ns
+        };
+        for (size_t i = 0; i < METRIC_COUNT; ++i) {
+            histograms_[i].Add(values[i]);
+        }
+
+        if (query.time_ns <= slow_threshold_ns_.load(std::memory_order_relaxed)) {
+            return;
+        }
+        std::lock_guard guard(slowest_mutex_);
+        auto position = std::find_if(slowest_.begin(), slowest_.end(), [&query](const SlowQuery& slow) {
+            return slow.stats.time_ns < query.time_ns;
+        });
+        if (position == slowest_.end() && slowest_.size() >= SLOWEST_COUNT) {
+            return;  // Порог устарел: другой поток успел записать запросы медленнее
+        }
+        slowest_.insert(position, SlowQuery{ std::string(from), std::string(to), query });
+        if (slowest_.size() > SLOWEST_COUNT) {
+            slowest_.pop_back();
+        }
+        if (slowest_.size() == SLOWEST_COUNT) {
+            slow_threshold_ns_.store(slowest_.back().stats.time_ns, std::memory_order_relaxed);
+        }
+    }
+
+    uint64_t RoutingStats::GetQueryCount() const {
+        return histograms_[0].count.load(std::memory_order_relaxed);
+    }
+
+    MetricSnapshot RoutingStats::GetHistogram(QueryMetric metric) const {
+        return histograms_.at(static_cast<size_t>(metric)).Snapshot();
+    }
+
+    std::vector<SlowQuery> RoutingStats::GetSlowest() const {
+        std::lock_guard guard(slowest_mutex_);
+        return slowest_;
+    }
+
+    void RoutingStats::Print(std::ostream& out) const {
+        // Форматирование — в локальном потоке: флаги и точность потока вызывающего не меняются
+        std::ostringstream text;
+        text << "routing queries: " << GetQueryCount() << '\n';
+        text << std::left << std::setw(14) << "metric" << std::right
+            << std::setw(16) << "total" << std::setw(12) << "mean"
+            << std::setw(12) << "p50" << std::setw(12) << "p90"
+            << std::setw(12) << "p99" << std::setw(14) << "max" << '\n';
+        for (size_t i = 0; i < METRIC_COUNT; ++i) {
+            const auto stats = histograms_[i].Snapshot();
+            text << std::left << std::setw(14) << ToString(static_cast<QueryMetric>(i)) << std::right
+                << std::setw(16) << stats.total
+                << std::setw(12) << stats.Mean()
+                << std::setw(12) << stats.Percentile(0.5)
+                << std::setw(12) << stats.Percentile(0.9)
+                << std::setw(12) << stats.Percentile(0.99)
+                << std::setw(14) << stats.max << '\n';
+        }
+
+        const auto slowest = GetSlowest();
+        if (!slowest.empty()) {
+            text << "slowest queries:\n";
+            for (const SlowQuery& slow : slowest) {
+                text << "  " << std::fixed << std::setprecision(3) << static_cast<double>(slow.stats.time_ns) / 1e6
+                    << " ms  " << slow.from << " -> " << slow.to
+                    << "  settled " << slow.stats.settled << ", relaxed " << slow.stats.relaxed
+                    << ", searches " << slow.stats.searches << ", path edges " << slow.stats.path_edges;
+                if (slow.stats.batch_size > 1) {
+                    text << ", share of batch of " << slow.stats.batch_size;
+                }
+                text << '\n';
+            }
+        }
+        out << text.str();
+    }
+
+} // namespace transport_router
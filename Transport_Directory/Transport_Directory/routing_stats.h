@@ -0,0 +1,129 @@
+#pragma once
+
+#include "profiler.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <iosfwd>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace transport_router {
+
+    /// Работа одного запроса маршрута
+    struct QueryStats {
+        uint64_t settled = 0;       ///< Раскрыто вершин (всеми поисками запроса)
+        uint64_t relaxed = 0;       ///< Просмотрено рёбер
+        uint64_t heap_pushes = 0;   ///< Вставок в очередь с приоритетом
+        uint64_t heap_pops = 0;     ///< Извлечений из очереди
+        uint64_t path_edges = 0;    ///< Рёбер в восстановленных маршрутах
+        uint64_t time_ns = 0;       ///< Время запроса
+        uint64_t searches = 0;      ///< Выполнено поисков (0 — ответ из таблицы AllPairs)
+        uint64_t batch_size = 1;    ///< Пар, деливших один поиск (BuildRoutes); счётчики и время — доля этой пары
+    };
+
+    /// Величины, по которым копятся гистограммы (порядок полей QueryStats)
+    enum class QueryMetric {
+        Settled,
+        Relaxed,
+        HeapPushes,
+        HeapPops,
+        PathEdges,
+        Time,       ///< В наносекундах
+        Count       ///< Число величин (не величина)
+    };
+
+    /// Имя величины для отчётов ("settled", "relaxed", ..., "time_ns")
+    std::string_view ToString(QueryMetric metric);
+
+    /**
+     * @brief Снимок гистограммы одной величины QueryMetric.
+     *
+     * Единица у всех полей — единица величины: штуки для счётчиков, наносекунды
+     * для Time. Корзины — та же разбивка, что у profiler::ScopeStats.
+     */
+    struct MetricSnapshot {
+        uint64_t count = 0;                 ///< Учтено запросов
+        uint64_t total = 0;                 ///< Сумма значений
+        uint64_t min = UINT64_MAX;
+        uint64_t max = 0;
+        std::array<uint64_t, profiler::ScopeStats::BUCKET_COUNT> buckets{};
+
+        /// Среднее (0, если запросов не было)
+        uint64_t Mean() const;
+
+        /// Перцентиль q ∈ [0, 1] — середина корзины, в которую он попал
+        uint64_t Percentile(double q) const;
+    };
+
+    /// Один из самых медленных запросов
+    struct SlowQuery {
+        std::string from;
+        std::string to;
+        QueryStats stats;
+    };
+
+    /**
+     * @brief Статистика работы маршрутизатора по запросам.
+     *
+     * Для каждой величины QueryMetric копится логарифмическая гистограмма
+     * (та же разбивка, что у profiler::ScopeStats: по 4 корзины на степень двойки).
+     * Счётчики атомарные: запросы записываются из нескольких потоков без блокировок.
+     * Блокировка берётся, только если запрос медленнее самого быстрого из SLOWEST_COUNT
+     * запомненных.
+     *
+     * Пакет BuildRoutes учитывается как отдельные запросы по каждой паре: работа общего
+     * поиска и его время делятся между парами поровну (QueryStats::batch_size), так что
+     * сумма по запросам совпадает с фактически выполненной работой.
+     *
+     * Сбор включается RoutingSettings::collect_stats; выключенный стоит
+     * маршрутизатору одной проверки указателя на запрос.
+     */
+    class RoutingStats {
+    public:
+        /// Сколько самых медленных запросов запоминать
+        static constexpr size_t SLOWEST_COUNT = 8;
+
+        /// Учитывает запрос from → to
+        void Record(std::string_view from, std::string_view to, const QueryStats& query);
+
+        /// Число учтённых запросов
+        uint64_t GetQueryCount() const;
+
+        /// Снимок гистограммы величины (count, сумма, минимум, максимум, перцентили)
+        MetricSnapshot GetHistogram(QueryMetric metric) const;
+
+        /// Самые медленные запросы, от самого медленного
+        std::vector<SlowQuery> GetSlowest() const;
+
+        /// Выводит таблицу гистограмм и самые медленные запросы
+        void Print(std::ostream& out) const;
+
+    private:
+        static constexpr size_t METRIC_COUNT = static_cast<size_t>(QueryMetric::Count);
+
+        // Гистограмма с атомарными счётчиками; разбивка на корзины — profiler::ScopeStats::BucketIndex
+        // (она не зависит от единицы, хотя у ScopeStats значения — наносекунды)
+        struct Histogram {
+            std::atomic<uint64_t> count{ 0 };
+            std::atomic<uint64_t> total{ 0 };
+            std::atomic<uint64_t> min{ UINT64_MAX };
+            std::atomic<uint64_t> max{ 0 };
+            std::array<std::atomic<uint64_t>, profiler::ScopeStats::BUCKET_COUNT> buckets{};
+
+            void Add(uint64_t value);
+            MetricSnapshot Snapshot() const;
+        };
+
+        std::array<Histogram, METRIC_COUNT> histograms_;
+
+        // Время самого быстрого из запомненных медленных запросов (когда их SLOWEST_COUNT)
+        std::atomic<uint64_t> slow_threshold_ns_{ 0 };
+        mutable std::mutex slowest_mutex_;
+        std::vector<SlowQuery> slowest_;    ///< По убыванию времени
+    };
+
+} // namespace transport_router
@@ -0,0 +1,76 @@
+#include "snapshot.h"
+#include "json_reader.h"
+
+namespace snapshot {
+
+	Snapshot::Snapshot(const json::Document& input, uint64_t version)
+		: version_(version)
+		, handler_(request_handler::RequestHandler::Create(LoadCatalogue(catalogue_, input), input))
+	{
+	}
+
+	const trans_cat::TransportCatalogue& Snapshot::LoadCatalogue(
+		trans_cat::TransportCatalogue& catalogue, const json::Document& input) {
+		json_reader::JSONReader reader(catalogue);
+		reader.LoadFromJson(input);
+		catalogue.Freeze();
+		return catalogue;
+	}
+
+	std::shared_ptr<const Snapshot> Snapshot::Build(const json::Document& input, uint64_t version) {
+		// Конструктор закрыт — make_shared недоступен
+		return std::shared_ptr<const Snapshot>(new Snapshot(input, version));
+	}
+
+	const trans_cat::TransportCatalogue& Snapshot::GetCatalogue() const {
+		return catalogue_;
+	}
+
+	const request_handler::RequestHandler& Snapshot::GetHandler() const {
+		return handler_;
+	}
+
+	uint64_t Snapshot::GetVersion() const {
+		return version_;
+	}
+
+	std::shared_ptr<const Snapshot> SnapshotStore::Acquire() const {
+		return state_->current.load(std::memory_order_acquire);
+	}
+
+	bool SnapshotStore::Publish(std::shared_ptr<const Snapshot> snapshot) {
+		return state_->Publish(std::move(snapshot));
+	}
+
+	bool SnapshotStore::State::Publish(std::shared_ptr<const Snapshot> snapshot) {
+		auto observed = current.load(std::memory_order_acquire);
+
+		// CAS-цикл: не даём более старой сборке перетереть более новую
+		while (!observed || observed->GetVersion() < snapshot->GetVersion()) {
+			if (current.compare_exchange_weak(observed, snapshot,
+				std::memory_order_acq_rel, std::memory_order_acquire)) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	std::shared_ptr<const Snapshot> SnapshotStore::Rebuild(const json::Document& input) {
+		auto snapshot = Snapshot::Build(input, state_->next_version.fetch_add(1));
+		Publish(snapshot);
+		return snapshot;
+	}
+
+	std::future<std::shared_ptr<const Snapshot>> SnapshotStore::RebuildAsync(json::Document input) {
+		// Версию резервируем сразу: порядок публикации = порядок вызовов
+		const uint64_t version = state_->next_version.fetch_add(1);
+
+		// Захватываем состояние, а не this: задача может пережить хранилище
+		return std::async(std::launch::async, [state = state_, version, input = std::move(input)]() {
+			auto snapshot = Snapshot::Build(input, version);
+			state->Publish(snapshot);
+			return snapshot;
+		});
+	}
+
+} // namespace snapshot
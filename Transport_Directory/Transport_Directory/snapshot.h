@@ -0,0 +1,126 @@
+#pragma once
+
+#include "transport_catalogue.h"
+#include "request_handler.h"
+#include "json.h"
+
+#include <atomic>
+#include <cstdint>
+#include <future>
+#include <memory>
+
+/**
+ * @brief Модуль неизменяемых снимков справочника (read-copy-update).
+ *
+ * Снимок объединяет всё, что нужно для ответа на запросы: каталог,
+ * маршрутизатор, рендерер и кэш отрисованной карты. После построения
+ * снимок не изменяется, поэтому читать его можно из любого числа потоков
+ * без блокировок.
+ *
+ * Схема работы:
+ * - читатель "закрепляет" текущий снимок (SnapshotStore::Acquire) и работает
+ *   с ним сколько угодно — даже если тем временем опубликован новый;
+ * - писатель строит следующий снимок в фоне (SnapshotStore::RebuildAsync)
+ *   и атомарно подменяет текущий (SnapshotStore::Publish);
+ * - старый снимок освобождается, когда его отпустит последний читатель
+ *   (эпоха снимка = время жизни его shared_ptr).
+ *
+ * Читатель никогда не ждёт писателя и никогда не видит частично построенных данных.
+ */
+namespace snapshot {
+
+	/**
+	 * @brief Неизменяемый снимок транспортного справочника.
+	 *
+	 * Создаётся только через Build и доступен только по указателю на константу.
+	 * Обработчик запросов ссылается на каталог этого же снимка, поэтому
+	 * снимок не копируется и не перемещается.
+	 */
+	class Snapshot {
+	public:
+		Snapshot(const Snapshot&) = delete;
+		Snapshot& operator=(const Snapshot&) = delete;
+
+		/**
+		 * @brief Строит снимок из входного JSON-документа.
+		 *
+		 * Загружает base_requests, строит маршрутизатор по routing_settings
+		 * и готовит рендерер (если заданы render_settings).
+		 * @param input Входной документ (тот же формат, что и для пакетного режима)
+		 * @param version Номер версии снимка
+		 * @throw json::ParsingError при ошибках формата
+		 */
+		static std::shared_ptr<const Snapshot> Build(const json::Document& input, uint64_t version);
+
+		const trans_cat::TransportCatalogue& GetCatalogue() const;
+		const request_handler::RequestHandler& GetHandler() const;
+
+		/// Номер версии: снимки, опубликованные позже, имеют больший номер
+		uint64_t GetVersion() const;
+
+	private:
+		Snapshot(const json::Document& input, uint64_t version);
+
+		// Загружает каталог и возвращает ссылку на него (для инициализации handler_)
+		static const trans_cat::TransportCatalogue& LoadCatalogue(
+			trans_cat::TransportCatalogue& catalogue, const json::Document& input);
+
+		uint64_t version_;
+		trans_cat::TransportCatalogue catalogue_;
+		request_handler::RequestHandler handler_;	///< Ссылается на catalogue_ — объявлен после него
+	};
+
+	/**
+	 * @brief Хранилище текущего снимка с атомарной подменой.
+	 *
+	 * Acquire и Publish потокобезопасны и не блокируют друг друга надолго:
+	 * подмена — это атомарная запись одного указателя.
+	 *
+	 * Состояние хранилища живёт в разделяемом объекте: фоновая сборка (RebuildAsync)
+	 * держит его сама, поэтому хранилище можно разрушить, не дожидаясь её future.
+	 */
+	class SnapshotStore {
+	public:
+		/**
+		 * @brief Возвращает текущий снимок (закрепляет его за читателем).
+		 * @return nullptr, если ещё ничего не опубликовано
+		 */
+		std::shared_ptr<const Snapshot> Acquire() const;
+
+		/**
+		 * @brief Публикует готовый снимок: новые читатели получат его.
+		 *
+		 * Снимок с версией меньше текущей не публикуется (защита от гонки фоновых сборок).
+		 * @return true, если снимок стал текущим
+		 */
+		bool Publish(std::shared_ptr<const Snapshot> snapshot);
+
+		/**
+		 * @brief Синхронно строит и публикует снимок из входного документа.
+		 * @return Опубликованный снимок
+		 */
+		std::shared_ptr<const Snapshot> Rebuild(const json::Document& input);
+
+		/**
+		 * @brief Строит и публикует снимок в фоновом потоке.
+		 *
+		 * Пока снимок строится, читатели продолжают работать с текущим.
+		 * Задача держит состояние хранилища, а не его самого: если хранилище разрушено
+		 * раньше, снимок всё равно достраивается и возвращается через future.
+		 * @param input Входной документ (перемещается в фоновую задачу)
+		 * @return future, через который можно дождаться окончания или получить исключение
+		 */
+		std::future<std::shared_ptr<const Snapshot>> RebuildAsync(json::Document input);
+
+	private:
+		struct State {
+			std::atomic<std::shared_ptr<const Snapshot>> current;
+			std::atomic<uint64_t> next_version = 1;
+
+			bool Publish(std::shared_ptr<const Snapshot> snapshot);
+		};
+
+		std::shared_ptr<State> state_ = std::make_shared<State>();	///< Разделяется с фоновыми сборками
+	};
+
+} // namespace snapshot
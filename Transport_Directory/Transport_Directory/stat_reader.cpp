@@ -1,84 +1,140 @@
 #include "stat_reader.h"
-#include <iomanip>
-#include <algorithm>
 
-namespace stat_r {
+#include <charconv>
+#include <ostream>
 
-	void ParseAndPrintStat(const trans_cat::TransportCatalogue& transport_catalogue, std::string_view request,
-		std::ostream& output) {
+namespace stat_r {
 
-		// Разбиваем запрос на название маршрута и команду
-		size_t pos = request.find(' ');
-		std::string_view command = request.substr(0, pos);
-		std::string_view obj_name = request.substr(pos + 1);
+	namespace {
 
-		if (command == "Bus") {
-			ProcessBusRequest(transport_catalogue, obj_name, output);
+		// Дописывает целое число
+		void AppendNumber(std::string& out, size_t value) {
+			char buffer[24];
+			const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+			out.append(buffer, result.ptr);
 		}
-		else if (command == "Stop") {
-			ProcessStopRequest(transport_catalogue, obj_name, output);
+
+		// Дописывает число в формате std::fixed с precision знаками после точки
+		// (std::to_chars округляет так же, как поток)
+		void AppendFixed(std::string& out, double value, int precision) {
+			char buffer[400];  // Хватает для любого double в формате fixed
+			const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value, std::chars_format::fixed, precision);
+			out.append(buffer, result.ptr);
 		}
-		else {
-			output << "Unknown command" << std::endl;
+
+		void AppendBusStat(const trans_cat::TransportCatalogue& transport_catalogue, std::string_view route_name,
+			std::string& out) {
+			out.append("Bus ").append(route_name);
+
+			// Ищем маршрут в транспортном справочнике
+			const auto stat = transport_catalogue.GetRouteStat(route_name);
+			if (!stat) {
+				out.append(": not found\n");
+				return;
+			}
+
+			// Выводим статистику в нужном формате
+			out.append(": ");
+			AppendNumber(out, stat->stop_count);
+			out.append(" stops on route, ");
+			AppendNumber(out, stat->unique_stop_count);
+			out.append(" unique stops, ");
+			AppendFixed(out, stat->route_length, 0);
+			out.append(" route length, ");
+			AppendFixed(out, stat->curvature, 5);
+			out.append(" curvature\n");
 		}
-	}
 
-	void ProcessBusRequest(const trans_cat::TransportCatalogue& transport_catalogue,
-		const std::string_view& route_name, std::ostream& output) {
+		void AppendStopStat(const trans_cat::TransportCatalogue& transport_catalogue, std::string_view stop_name,
+			std::string& out) {
+			out.append("Stop ").append(stop_name);
 
-		// Ищем маршрут в транспортном справочнике
-		auto route = transport_catalogue.FindRoute(route_name);
-		if (route) {
+			const auto* stop = transport_catalogue.FindStop(stop_name);
+			if (!stop) {
+				out.append(": not found\n");
+				return;
+			}
 
-			// Получаем статистику по маршруту
-			trans_cat::RouteStatistics stat = transport_catalogue.GetStat(route);
+			// Маршруты остановки уже отсортированы по имени
+			const auto routes = transport_catalogue.GetBusesByStop(stop);
+			if (routes.empty()) {
+				out.append(": no buses\n");
+				return;
+			}
 
-			// Выводим статистику в нужном формате
-			output << "Bus " << route_name << ": "
-				<< stat.total_stops << " stops on route, "
-				<< stat.unique_stops << " unique stops, "
-				<< std::fixed << std::setprecision(0) << stat.route_length << " route length, "
-				<< std::fixed << std::setprecision(5) << stat.curvature << " curvature"
-				<< std::endl;
+			out.append(": buses");
+			for (const auto* route : routes) {
+				out.push_back(' ');
+				out.append(route->name);
+			}
+			out.push_back('\n');
+		}
+
+		void AppendStat(const trans_cat::TransportCatalogue& transport_catalogue, std::string_view request,
+			std::string& out) {
+
+			// Разбиваем запрос на название маршрута и команду
+			size_t pos = request.find(' ');
+			std::string_view command = request.substr(0, pos);
+			std::string_view obj_name = request.substr(pos + 1);
+
+			if (command == "Bus") {
+				AppendBusStat(transport_catalogue, obj_name, out);
+			}
+			else if (command == "Stop") {
+				AppendStopStat(transport_catalogue, obj_name, out);
+			}
+			else {
+				out.append("Unknown command\n");
+			}
 		}
-		else {
 
-			// Если маршрут не найден
-			output << "Bus " << route_name << ": not found" << std::endl;
+		// Форматирует ответ в буфер потока (его ёмкость переиспользуется) и пишет одним вызовом
+		template <typename Append>
+		void Print(std::ostream& output, Append&& append) {
+			thread_local std::string buffer;
+			buffer.clear();
+			append(buffer);
+			output.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
 		}
+
+	} // namespace
+
+	void ParseAndPrintStat(const trans_cat::TransportCatalogue& transport_catalogue, std::string_view request,
+		std::ostream& output) {
+		Print(output, [&](std::string& out) { AppendStat(transport_catalogue, request, out); });
+	}
+
+	void ProcessBusRequest(const trans_cat::TransportCatalogue& transport_catalogue,
+		const std::string_view& route_name, std::ostream& output) {
+		Print(output, [&](std::string& out) { AppendBusStat(transport_catalogue, route_name, out); });
 	}
 
 	void ProcessStopRequest(const trans_cat::TransportCatalogue& transport_catalogue,
 		const std::string_view& stop_name, std::ostream& output) {
-		auto stop = transport_catalogue.FindStop(stop_name);
-		if (stop) {
-		
-			// Остановка найдена
-			auto& routes_names = transport_catalogue.GetRoutesNamesByStop(stop);
-
-			if (routes_names.empty()) {
-				output << "Stop " << stop_name << ": no buses" << std::endl;
-			}
-			else {
+		Print(output, [&](std::string& out) { AppendStopStat(transport_catalogue, stop_name, out); });
+	}
 
-				// Выводим отсортированные названия маршрутов
-				output << "Stop " << stop_name << ": buses ";
-
-				auto it = routes_names.begin();
-				for (; it != routes_names.end(); ++it) {
-					output << *it;
-					if (std::next(it) != routes_names.end()) {
-						output << " ";
-					}
-				}
-				output << std::endl;
-			}
-		}
-		else {
-			
-			// Остановка не найдена
-			output << "Stop " << stop_name << ": not found" << std::endl;
+	StatWriter::StatWriter(std::ostream& output)
+		: output_(output) {
+		buffer_.reserve(BLOCK_SIZE + BLOCK_SIZE / 4);
+	}
+
+	StatWriter::~StatWriter() {
+		Flush();
+	}
+
+	void StatWriter::ParseAndPrintStat(const trans_cat::TransportCatalogue& transport_catalogue,
+		std::string_view request) {
+		AppendStat(transport_catalogue, request, buffer_);
+		if (buffer_.size() >= BLOCK_SIZE) {
+			Flush();
 		}
 	}
 
+	void StatWriter::Flush() {
+		output_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+		buffer_.clear();
+	}
+
 } // namespace stat_r
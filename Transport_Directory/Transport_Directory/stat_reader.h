@@ -1,6 +1,7 @@
 #pragma once
 
 #include <iosfwd>
+#include <string>
 #include <string_view>
 
 #include "transport_catalogue.h"
@@ -19,4 +20,35 @@ namespace stat_r {
 	void ParseAndPrintStat(const trans_cat::TransportCatalogue& transport_catalogue,
 		std::string_view request, std::ostream& output);
 
-} // namespace stat_r
\ No newline at end of file
+	/*
+	 * Класс StatWriter - вывод ответов на поток запросов блоками.
+	 *
+	 * Ответы форматируются (std::to_chars) в собственный буфер и пишутся в поток
+	 * одним вызовом write, когда буфер набирает BLOCK_SIZE байт, при Flush
+	 * и в деструкторе. Поток при этом не сбрасывается. Вывод побайтно совпадает
+	 * с выводом ParseAndPrintStat.
+	 */
+	class StatWriter {
+	public:
+		// Размер блока, после которого буфер пишется в поток
+		static constexpr size_t BLOCK_SIZE = 64 * 1024;
+
+		explicit StatWriter(std::ostream& output);
+
+		StatWriter(const StatWriter&) = delete;
+		StatWriter& operator=(const StatWriter&) = delete;
+
+		~StatWriter();
+
+		// Парсит запрос и добавляет ответ в буфер
+		void ParseAndPrintStat(const trans_cat::TransportCatalogue& transport_catalogue, std::string_view request);
+
+		// Пишет накопленные ответы в поток
+		void Flush();
+
+	private:
+		std::ostream& output_;
+		std::string buffer_;
+	};
+
+} // namespace stat_r
@@ -0,0 +1,396 @@
+#include "stop_name_index.h"
+
+#include <algorithm>
+#include <array>
+#include <numeric>
+#include <utility>
+
+namespace trans_cat {
+
+	namespace {
+
+		// Нижний регистр для латиницы и кириллицы, "ё" → "е"
+		char32_t Fold(char32_t symbol) {
+			if (symbol >= U'A' && symbol <= U'Z') {
+				return symbol + (U'a' - U'A');
+			}
+			if (symbol == U'\u0401' || symbol == U'\u0451') {  // Ё, ё
+				return U'\u0435';                                  // е
+			}
+			if (symbol >= U'\u0410' && symbol <= U'\u042F') {  // А..Я
+				return symbol + 0x20;
+			}
+			return symbol;
+		}
+
+		/**
+		 * @brief Битово-параллельное расстояние Левенштейна (Майерс, вариант Хюрё).
+		 *
+		 * Столбец таблицы динамического программирования для шаблона длиной до 64
+		 * символов хранится разностями соседних клеток в двух машинных словах —
+		 * один символ текста обрабатывается за десяток операций вместо длины шаблона.
+		 * Маски символов шаблона лежат в таблице прямого отображения; если два
+		 * символа шаблона попали в одну ячейку, IsValid() == false.
+		 */
+		class BitParallelPattern {
+		public:
+			explicit BitParallelPattern(std::u32string_view pattern)
+				: length_(pattern.size())
+			{
+				if (pattern.empty() || pattern.size() > 64) {
+					valid_ = false;
+					return;
+				}
+				for (size_t i = 0; i < pattern.size(); ++i) {
+					Slot& slot = table_[SlotIndex(pattern[i])];
+					if (slot.mask != 0 && slot.symbol != pattern[i]) {
+						valid_ = false;
+						return;
+					}
+					slot.symbol = pattern[i];
+					slot.mask |= uint64_t{ 1 } << i;
+				}
+			}
+
+			bool IsValid() const {
+				return valid_;
+			}
+
+			// Расстояние до text, если оно не больше max_distance, иначе max_distance + 1
+			size_t Distance(std::u32string_view text, size_t max_distance) const {
+				const uint64_t last = uint64_t{ 1 } << (length_ - 1);
+				uint64_t positive = ~uint64_t{ 0 };
+				uint64_t negative = 0;
+				size_t score = length_;
+
+				for (size_t j = 0; j < text.size(); ++j) {
+					const Slot& slot = table_[SlotIndex(text[j])];
+					const uint64_t equal = slot.symbol == text[j] ? slot.mask : 0;
+
+					const uint64_t xv = equal | negative;
+					const uint64_t xh = (((equal & positive) + positive) ^ positive) | equal;
+					uint64_t horizontal_positive = negative | ~(xh | positive);
+					uint64_t horizontal_negative = positive & xh;
+					if (horizontal_positive & last) {
+						++score;
+					}
+					else if (horizontal_negative & last) {
+						--score;
+					}
+
+					// Каждый следующий символ текста без пары стоит правки: D[0][j] = j
+					horizontal_positive = (horizontal_positive << 1) | 1;
+					horizontal_negative <<= 1;
+					positive = horizontal_negative | ~(xv | horizontal_positive);
+					negative = horizontal_positive & xv;
+
+					// Оставшиеся символы уменьшат расстояние не больше чем на своё число
+					if (score > max_distance + (text.size() - j - 1)) {
+						return max_distance + 1;
+					}
+				}
+				return std::min(score, max_distance + 1);
+			}
+
+		private:
+			struct Slot {
+				char32_t symbol = 0;
+				uint64_t mask = 0;
+			};
+
+			static size_t SlotIndex(char32_t symbol) {
+				return (static_cast<uint32_t>(symbol) * 2654435761u) >> 24;
+			}
+
+			std::array<Slot, 256> table_{};
+			size_t length_ = 0;
+			bool valid_ = true;
+		};
+
+	} // namespace
+
+	StopNameIndex::StopNameIndex(const std::unordered_map<std::string_view, const Stop*>& stops) {
+		stops_.reserve(stops.size());
+		key_offsets_.reserve(stops.size() + 1);
+		key_offsets_.push_back(0);
+		for (const auto& [name, stop] : stops) {
+			const std::u32string key = Normalize(name);
+			stops_.push_back(stop);
+			keys_.insert(keys_.end(), key.begin(), key.end());
+			key_offsets_.push_back(static_cast<uint32_t>(keys_.size()));
+		}
+
+		// Разные имена могут дать один ключ ("Ёлки" и "елки") — порядок между ними по имени
+		sorted_.resize(stops_.size());
+		std::iota(sorted_.begin(), sorted_.end(), 0);
+		std::sort(sorted_.begin(), sorted_.end(), [this](uint32_t lhs, uint32_t rhs) {
+			const Key lhs_key = GetKey(lhs);
+			const Key rhs_key = GetKey(rhs);
+			return lhs_key != rhs_key ? lhs_key < rhs_key : stops_[lhs]->name < stops_[rhs]->name;
+		});
+
+		by_length_.resize(stops_.size());
+		std::iota(by_length_.begin(), by_length_.end(), 0);
+		std::stable_sort(by_length_.begin(), by_length_.end(), [this](uint32_t lhs, uint32_t rhs) {
+			return GetKey(lhs).size() < GetKey(rhs).size();
+		});
+
+		// Пары (биграмма, номер) в порядке by_length_: после устойчивой сортировки
+		// по биграмме список каждой биграммы остаётся упорядоченным по длине ключа
+		std::vector<std::pair<uint64_t, uint32_t>> pairs;
+		for (uint32_t id : by_length_) {
+			for (uint64_t gram : GetGrams(GetKey(id))) {
+				pairs.emplace_back(gram, id);
+			}
+		}
+		std::stable_sort(pairs.begin(), pairs.end(), [](const auto& lhs, const auto& rhs) {
+			return lhs.first < rhs.first;
+		});
+
+		postings_.reserve(pairs.size());
+		for (const auto& [gram, id] : pairs) {
+			if (grams_.empty() || grams_.back() != gram) {
+				grams_.push_back(gram);
+				gram_offsets_.push_back(static_cast<uint32_t>(postings_.size()));
+			}
+			postings_.push_back(id);
+		}
+		gram_offsets_.push_back(static_cast<uint32_t>(postings_.size()));
+	}
+
+	std::vector<StopMatch> StopNameIndex::Search(std::string_view query, size_t limit, size_t max_distance) const {
+		std::vector<StopMatch> result;
+		const std::u32string key = Normalize(query);
+		if (key.empty() || limit == 0 || stops_.empty()) {
+			return result;
+		}
+
+		FindPrefixed(key, limit, result);
+		if (result.size() < limit) {
+			FindFuzzy(key, limit, std::min(max_distance, MAX_DISTANCE), result);
+		}
+		return result;
+	}
+
+	size_t StopNameIndex::DefaultMaxDistance(std::string_view query) {
+		const size_t length = Normalize(query).size();
+		return length <= 3 ? 0 : length <= 6 ? 1 : 2;
+	}
+
+	size_t StopNameIndex::GetSize() const {
+		return stops_.size();
+	}
+
+	size_t StopNameIndex::GetMemoryUsage() const {
+		return stops_.capacity() * sizeof(const Stop*)
+			+ keys_.capacity() * sizeof(char32_t)
+			+ (key_offsets_.capacity() + sorted_.capacity() + by_length_.capacity()
+				+ gram_offsets_.capacity() + postings_.capacity()) * sizeof(uint32_t)
+			+ grams_.capacity() * sizeof(uint64_t);
+	}
+
+	/**
+	 * Некорректные последовательности UTF-8 не отбрасываются: байт, с которого
+	 * не начинается допустимый символ, становится символом сам по себе.
+	 */
+	std::u32string StopNameIndex::Normalize(std::string_view name) {
+		std::u32string key;
+		key.reserve(name.size());
+		for (size_t pos = 0; pos < name.size();) {
+			const auto lead = static_cast<unsigned char>(name[pos]);
+			size_t length = lead < 0x80 ? 1
+				: (lead >> 5) == 0x06 ? 2
+				: (lead >> 4) == 0x0E ? 3
+				: (lead >> 3) == 0x1E ? 4
+				: 1;
+			if (pos + length > name.size()) {
+				length = 1;
+			}
+
+			char32_t symbol = length == 1 ? lead : lead & (0x7F >> length);
+			for (size_t i = 1; i < length; ++i) {
+				symbol = (symbol << 6) | (static_cast<unsigned char>(name[pos + i]) & 0x3F);
+			}
+			key.push_back(Fold(symbol));
+			pos += length;
+		}
+		return key;
+	}
+
+	std::vector<uint64_t> StopNameIndex::GetGrams(Key key) {
+		// Символ занимает не больше 21 бита — триграмма помещается в 64 бита
+		auto gram = [](char32_t first, char32_t second, char32_t third) {
+			return (uint64_t{ first } << 42) | (uint64_t{ second } << 21) | third;
+		};
+
+		std::vector<uint64_t> grams;
+		grams.reserve(key.size() + GRAM_SIZE - 1);
+		char32_t first = 0;
+		char32_t second = 0;
+		for (char32_t symbol : key) {
+			grams.push_back(gram(first, second, symbol));
+			first = second;
+			second = symbol;
+		}
+		grams.push_back(gram(first, second, 0));
+		grams.push_back(gram(second, 0, 0));
+
+		std::sort(grams.begin(), grams.end());
+		grams.erase(std::unique(grams.begin(), grams.end()), grams.end());
+		return grams;
+	}
+
+	/**
+	 * Построчный алгоритм Вагнера — Фишера: строка короче — по столбцам.
+	 * Поиск прекращается, как только все значения строки превысили порог.
+	 */
+	size_t StopNameIndex::BoundedDistance(Key lhs, Key rhs, size_t max_distance,
+		std::vector<size_t>& row, std::vector<size_t>& next) {
+		if (lhs.size() > rhs.size()) {
+			std::swap(lhs, rhs);
+		}
+		if (rhs.size() - lhs.size() > max_distance) {
+			return max_distance + 1;
+		}
+
+		row.resize(lhs.size() + 1);
+		next.resize(lhs.size() + 1);
+		std::iota(row.begin(), row.end(), 0);
+		for (size_t j = 1; j <= rhs.size(); ++j) {
+			next[0] = j;
+			size_t row_min = next[0];
+			for (size_t i = 1; i <= lhs.size(); ++i) {
+				next[i] = std::min({ row[i] + 1, next[i - 1] + 1, row[i - 1] + (lhs[i - 1] != rhs[j - 1]) });
+				row_min = std::min(row_min, next[i]);
+			}
+			if (row_min > max_distance) {
+				return max_distance + 1;
+			}
+			std::swap(row, next);
+		}
+		return std::min(row.back(), max_distance + 1);
+	}
+
+	StopNameIndex::Key StopNameIndex::GetKey(uint32_t id) const {
+		return Key(keys_.data() + key_offsets_[id], key_offsets_[id + 1] - key_offsets_[id]);
+	}
+
+	void StopNameIndex::FindPrefixed(Key key, size_t limit, std::vector<StopMatch>& result) const {
+		auto it = std::lower_bound(sorted_.begin(), sorted_.end(), key, [this](uint32_t id, Key value) {
+			return GetKey(id) < value;
+		});
+		for (; it != sorted_.end() && result.size() < limit; ++it) {
+			const Key name = GetKey(*it);
+			if (!name.starts_with(key)) {
+				break;
+			}
+			result.push_back(StopMatch{
+				.stop = stops_[*it],
+				.kind = name.size() == key.size() ? StopMatch::Kind::Exact : StopMatch::Kind::Prefix,
+				.distance = name.size() - key.size() });
+		}
+	}
+
+	void StopNameIndex::FindFuzzy(Key key, size_t limit, size_t max_distance, std::vector<StopMatch>& result) const {
+		if (max_distance == 0) {
+			return;
+		}
+		const size_t min_length = key.size() > max_distance ? key.size() - max_distance : 0;
+		const size_t max_length = key.size() + max_distance;
+		const std::vector<uint64_t> grams = GetGrams(key);
+
+		// Имя на расстоянии не больше k содержит не меньше |G| - GRAM_SIZE·k триграмм запроса:
+		// из любых r списков триграмм запроса оно есть хотя бы в r - GRAM_SIZE·k. Берём
+		// самые редкие списки: минимум GRAM_SIZE·k + 1 (порог 1), а пока просмотр дёшев —
+		// больше, повышая порог. Имя становится кандидатом, когда его счётчик достигает
+		// порога, — каждое ровно один раз. Если триграмм меньше GRAM_SIZE·k + 1, фильтр
+		// не работает — проверяются все имена подходящей длины
+		std::vector<uint32_t> candidates;
+		const size_t slack = GRAM_SIZE * max_distance;
+		if (grams.size() <= slack) {
+			const auto [first, last] = LengthRange(by_length_.data(), by_length_.data() + by_length_.size(),
+				min_length, max_length);
+			candidates.assign(first, last);
+		}
+		else {
+			// Списки триграмм запроса в пределах длины; отсутствующей в индексе — пустой
+			std::vector<std::pair<const uint32_t*, const uint32_t*>> lists;
+			lists.reserve(grams.size());
+			for (uint64_t gram : grams) {
+				const auto it = std::lower_bound(grams_.begin(), grams_.end(), gram);
+				if (it == grams_.end() || *it != gram) {
+					lists.emplace_back(nullptr, nullptr);
+					continue;
+				}
+				const size_t index = static_cast<size_t>(it - grams_.begin());
+				lists.push_back(LengthRange(postings_.data() + gram_offsets_[index],
+					postings_.data() + gram_offsets_[index + 1], min_length, max_length));
+			}
+			std::sort(lists.begin(), lists.end(), [](const auto& lhs, const auto& rhs) {
+				return lhs.second - lhs.first < rhs.second - rhs.first;
+			});
+
+			size_t scanned = slack + 1;
+			size_t postings = 0;
+			for (size_t i = 0; i < scanned; ++i) {
+				postings += static_cast<size_t>(lists[i].second - lists[i].first);
+			}
+			const size_t budget = FUZZY_SCAN_FACTOR * postings + lists.size();
+			// Счётчики однобайтовые: имя встречается в каждом списке не больше раза
+			const size_t max_scanned = std::min<size_t>(lists.size(), UINT8_MAX);
+			while (scanned < max_scanned && postings + static_cast<size_t>(lists[scanned].second - lists[scanned].first) <= budget) {
+				postings += static_cast<size_t>(lists[scanned].second - lists[scanned].first);
+				++scanned;
+			}
+
+			const size_t threshold = scanned - slack;
+			std::vector<uint8_t> counts(stops_.size());
+			for (size_t i = 0; i < scanned; ++i) {
+				for (const uint32_t* it = lists[i].first; it != lists[i].second; ++it) {
+					if (++counts[*it] == threshold) {
+						candidates.push_back(*it);
+					}
+				}
+			}
+		}
+
+		std::vector<StopMatch> matches;
+		const BitParallelPattern pattern(key);
+		std::vector<size_t> row;
+		std::vector<size_t> next;
+		for (uint32_t id : candidates) {
+			const Key name = GetKey(id);
+			if (name.starts_with(key)) {
+				continue;  // Уже среди совпадений по префиксу
+			}
+			const size_t distance = pattern.IsValid()
+				? pattern.Distance(name, max_distance)
+				: BoundedDistance(key, name, max_distance, row, next);
+			if (distance <= max_distance) {
+				matches.push_back(StopMatch{ .stop = stops_[id], .kind = StopMatch::Kind::Fuzzy, .distance = distance });
+			}
+		}
+		std::sort(matches.begin(), matches.end(), [](const StopMatch& lhs, const StopMatch& rhs) {
+			return lhs.distance != rhs.distance ? lhs.distance < rhs.distance : lhs.stop->name < rhs.stop->name;
+		});
+
+		for (const StopMatch& match : matches) {
+			if (result.size() >= limit) {
+				break;
+			}
+			result.push_back(match);
+		}
+	}
+
+	std::pair<const uint32_t*, const uint32_t*> StopNameIndex::LengthRange(
+		const uint32_t* first, const uint32_t* last, size_t min_length, size_t max_length) const {
+		const uint32_t* begin = std::partition_point(first, last, [&](uint32_t id) {
+			return GetKey(id).size() < min_length;
+		});
+		const uint32_t* end = std::partition_point(begin, last, [&](uint32_t id) {
+			return GetKey(id).size() <= max_length;
+		});
+		return { begin, end };
+	}
+
+} // namespace trans_cat
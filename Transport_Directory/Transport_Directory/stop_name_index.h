@@ -0,0 +1,117 @@
+#pragma once
+
+#include "domain.h"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace trans_cat {
+
+	/// Кандидат поиска остановки по имени (см. StopNameIndex::Search)
+	struct StopMatch {
+		enum class Kind {
+			Exact,   ///< Имя совпадает с запросом (без учёта регистра и ё/е)
+			Prefix,  ///< Запрос — начало имени
+			Fuzzy    ///< Имя отличается от запроса не более чем на max_distance правок
+		};
+
+		const Stop* stop = nullptr;
+		Kind kind = Kind::Exact;
+		size_t distance = 0;  ///< Расстояние Левенштейна от запроса до имени, в символах
+	};
+
+	/**
+	 * @brief Индекс имён остановок для поиска по префиксу и с опечатками.
+	 *
+	 * Имена нормализуются: UTF-8 раскладывается на символы, латиница и кириллица
+	 * приводятся к нижнему регистру, "ё" заменяется на "е". Все ключи лежат
+	 * подряд в одном массиве символов.
+	 *
+	 * - Префикс: ключи упорядочены (массив номеров вместо дерева), имена с общим
+	 *   началом образуют непрерывный диапазон — двоичный поиск, O(log N + ответ).
+	 * - Опечатки: инвертированный индекс триграмм ключа, дополненного с обеих сторон.
+	 *   Одна правка разрушает не больше трёх триграмм, поэтому имя на расстоянии
+	 *   не больше k есть хотя бы в r - 3k из любых r списков триграмм запроса.
+	 *   Просматриваются самые редкие списки (не меньше 3k + 1), имена считаются
+	 *   в счётчиках; кандидаты — набравшие порог. Списки упорядочены по длине
+	 *   ключа: просматриваются только имена длиной |запрос| ± k. Кандидаты
+	 *   проверяются битово-параллельным алгоритмом Левенштейна.
+	 *
+	 * Индекс неизменяем: строится по готовому набору остановок (TransportCatalogue::Freeze).
+	 * Указатели на остановки и их имена должны пережить индекс.
+	 */
+	class StopNameIndex {
+	public:
+		/// Наибольшее допустимое число правок
+		static constexpr size_t MAX_DISTANCE = 3;
+
+		/// Длина n-граммы индекса опечаток
+		static constexpr size_t GRAM_SIZE = 3;
+
+		/// Во сколько раз можно превысить объём обязательных списков триграмм ради более строгого порога
+		static constexpr size_t FUZZY_SCAN_FACTOR = 4;
+
+		StopNameIndex() = default;
+
+		/// Строит индекс по словарю "имя → остановка"
+		explicit StopNameIndex(const std::unordered_map<std::string_view, const Stop*>& stops);
+
+		/**
+		 * @brief Ищет остановки, подходящие под запрос.
+		 * @param query Имя или его начало, возможно с опечатками
+		 * @param limit Наибольшее число кандидатов
+		 * @param max_distance Допустимое число правок (не больше MAX_DISTANCE)
+		 * @return Сначала точное совпадение, затем имена с этим префиксом (по алфавиту),
+		 *         затем имена с опечатками (по числу правок, затем по алфавиту)
+		 */
+		std::vector<StopMatch> Search(std::string_view query, size_t limit, size_t max_distance) const;
+
+		/// Число правок по умолчанию: 0 для запросов до 3 символов, 1 — до 6, иначе 2
+		static size_t DefaultMaxDistance(std::string_view query);
+
+		/// Число имён в индексе
+		size_t GetSize() const;
+
+		/// Объём памяти индекса, байт
+		size_t GetMemoryUsage() const;
+
+	private:
+		using Key = std::u32string_view;
+
+		// Нормализованный ключ имени (см. описание класса)
+		static std::u32string Normalize(std::string_view name);
+
+		// Триграммы ключа, дополненного двумя символами 0 с обеих сторон, без повторов
+		static std::vector<uint64_t> GetGrams(Key key);
+
+		// Расстояние Левенштейна, если оно не больше max_distance, иначе max_distance + 1;
+		// row и next — рабочие строки таблицы (чтобы не выделять память на каждое имя)
+		static size_t BoundedDistance(Key lhs, Key rhs, size_t max_distance,
+			std::vector<size_t>& row, std::vector<size_t>& next);
+
+		Key GetKey(uint32_t id) const;
+
+		// Добавляет в result имена, начинающиеся с key (точное совпадение — первым)
+		void FindPrefixed(Key key, size_t limit, std::vector<StopMatch>& result) const;
+
+		// Добавляет в result имена на расстоянии от 1 до max_distance, не начинающиеся с key
+		void FindFuzzy(Key key, size_t limit, size_t max_distance, std::vector<StopMatch>& result) const;
+
+		// Диапазон [first, last) в ids, упорядоченном по длине ключа, с длинами в [min_length, max_length]
+		std::pair<const uint32_t*, const uint32_t*> LengthRange(
+			const uint32_t* first, const uint32_t* last, size_t min_length, size_t max_length) const;
+
+		std::vector<const Stop*> stops_;        ///< Остановка по номеру имени
+		std::vector<char32_t> keys_;            ///< Нормализованные имена подряд
+		std::vector<uint32_t> key_offsets_;     ///< Начало ключа по номеру (+ конец последнего)
+		std::vector<uint32_t> sorted_;          ///< Номера по возрастанию ключа
+		std::vector<uint32_t> by_length_;       ///< Номера по (длина ключа, номер)
+		std::vector<uint64_t> grams_;           ///< Различные триграммы по возрастанию
+		std::vector<uint32_t> gram_offsets_;    ///< Начало списка триграммы в postings_ (+ конец)
+		std::vector<uint32_t> postings_;        ///< Номера имён; в списке триграммы — по длине ключа
+	};
+
+} // namespace trans_cat
@@ -0,0 +1,79 @@
+#include "stop_route_index.h"
+
+#include <algorithm>
+
+namespace trans_cat {
+
+	void StopRouteIndex::Assign(size_t stop_count, std::vector<StopRouteEntry> entries) {
+		std::sort(entries.begin(), entries.end(), [](const StopRouteEntry& lhs, const StopRouteEntry& rhs) {
+			return lhs.stop != rhs.stop ? lhs.stop < rhs.stop : RouteNameLess{}(lhs.route, rhs.route);
+		});
+
+		offsets_.assign(stop_count + 1, 0);
+		routes_.clear();
+		routes_.reserve(entries.size());
+		pending_.clear();
+
+		for (size_t i = 0; i < entries.size(); ++i) {
+			const StopRouteEntry& entry = entries[i];
+			if (i > 0 && entries[i - 1].stop == entry.stop && entries[i - 1].route == entry.route) {
+				continue;
+			}
+			routes_.push_back(entry.route);
+			++offsets_[entry.stop + 1];
+		}
+		for (size_t stop = 0; stop < stop_count; ++stop) {
+			offsets_[stop + 1] += offsets_[stop];
+		}
+	}
+
+	std::vector<const Route*>& StopRouteIndex::GetPending(uint32_t stop) {
+		if (auto it = pending_.find(stop); it != pending_.end()) {
+			return it->second;
+		}
+		// Копия берётся из массива до вставки: после неё Find вернул бы новую (пустую) копию
+		const auto routes = Find(stop);
+		return pending_.emplace(stop, std::vector<const Route*>(routes.begin(), routes.end())).first->second;
+	}
+
+	void StopRouteIndex::Add(uint32_t stop, const Route* route) {
+		auto& routes = GetPending(stop);
+		auto pos = std::lower_bound(routes.begin(), routes.end(), route, RouteNameLess{});
+		if (pos == routes.end() || *pos != route) {
+			routes.insert(pos, route);
+		}
+	}
+
+	void StopRouteIndex::Remove(uint32_t stop, const Route* route) {
+		if (Find(stop).empty()) {
+			return;
+		}
+		std::erase(GetPending(stop), route);
+	}
+
+	void StopRouteIndex::Compact(size_t stop_count) {
+		if (pending_.empty() && offsets_.size() == stop_count + 1) {
+			return;
+		}
+
+		std::vector<StopRouteEntry> entries;
+		entries.reserve(routes_.size());
+		for (uint32_t stop = 0; stop < stop_count; ++stop) {
+			for (const Route* route : Find(stop)) {
+				entries.push_back(StopRouteEntry{ stop, route });
+			}
+		}
+		Assign(stop_count, std::move(entries));
+	}
+
+	void StopRouteIndex::Clear() {
+		offsets_.clear();
+		routes_.clear();
+		pending_.clear();
+	}
+
+	size_t StopRouteIndex::GetMemoryUsage() const {
+		return offsets_.capacity() * sizeof(uint32_t) + routes_.capacity() * sizeof(const Route*);
+	}
+
+} // namespace trans_cat
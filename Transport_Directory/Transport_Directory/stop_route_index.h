@@ -0,0 +1,83 @@
+#pragma once
+
+#include "domain.h"
+
+#include <cstdint>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace trans_cat {
+
+	// Компаратор для сортировки маршрутов по наименованию
+	struct RouteNameLess {
+		bool operator()(const Route* lhs, const Route* rhs) const {
+			return lhs->name < rhs->name;
+		}
+	};
+
+	/// Маршрут route проходит через остановку с номером Stop::id
+	struct StopRouteEntry {
+		uint32_t stop = 0;
+		const Route* route = nullptr;
+	};
+
+	/**
+	 * @brief Маршруты, проходящие через остановку, сгруппированные по остановке (CSR).
+	 *
+	 * Списки всех остановок лежат подряд в одном массиве, каждый отсортирован
+	 * по имени маршрута (RouteNameLess) и без повторов; offsets_ даёт начало
+	 * списка остановки с номером Stop::id. Поиск — два чтения offsets_
+	 * без хэширования, и весь индекс — два непрерывных блока памяти.
+	 *
+	 * Изменения после построения (Add, Remove) ведутся в небольшом словаре копий
+	 * списков изменённых остановок; копия имеет приоритет над массивом.
+	 * Compact переносит изменения в массив.
+	 */
+	class StopRouteIndex {
+	public:
+		/**
+		 * @brief Строит индекс заново из пар (остановка, маршрут).
+		 * @param stop_count Число остановок (номера в entries меньше него)
+		 * @param entries Пары в любом порядке; повторы отбрасываются
+		 */
+		void Assign(size_t stop_count, std::vector<StopRouteEntry> entries);
+
+		/// Добавляет маршрут в список остановки (повтор не добавляется)
+		void Add(uint32_t stop, const Route* route);
+
+		/// Удаляет маршрут из списка остановки
+		void Remove(uint32_t stop, const Route* route);
+
+		/// Маршруты остановки, отсортированные по имени (пустой span, если их нет)
+		std::span<const Route* const> Find(uint32_t stop) const {
+			if (!pending_.empty()) {
+				if (auto it = pending_.find(stop); it != pending_.end()) {
+					return it->second;
+				}
+			}
+			if (static_cast<size_t>(stop) + 1 >= offsets_.size()) {
+				return {};
+			}
+			return std::span<const Route* const>(routes_.data() + offsets_[stop], offsets_[stop + 1] - offsets_[stop]);
+		}
+
+		/// Переносит изменения, накопленные через Add и Remove, в основной массив
+		void Compact(size_t stop_count);
+
+		/// Удаляет все списки
+		void Clear();
+
+		/// Объём памяти индекса, байт (без словаря изменений)
+		size_t GetMemoryUsage() const;
+
+	private:
+		std::vector<uint32_t> offsets_;     ///< Начало списка остановки в routes_ (+ конец последнего)
+		std::vector<const Route*> routes_;  ///< Маршруты, упорядоченные по (остановка, имя маршрута)
+		std::unordered_map<uint32_t, std::vector<const Route*>> pending_;  ///< Списки, изменённые после Assign/Compact
+
+		// Копия списка остановки в словаре изменений (создаётся из массива при первом изменении)
+		std::vector<const Route*>& GetPending(uint32_t stop);
+	};
+
+} // namespace trans_cat
@@ -0,0 +1,53 @@
+#include "string_arena.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace trans_cat {
+
+    StringArena::StringArena(size_t block_size)
+        : block_size_(std::max<size_t>(block_size, 1))
+    {
+    }
+
+    std::string_view StringArena::Store(std::string_view text) {
+        ++string_count_;
+        stored_bytes_ += text.size();
+        if (text.empty()) {
+            return {};
+        }
+
+        char* destination = nullptr;
+        if (text.size() > block_size_ / 4) {
+            // Длинная строка — в отдельный блок; общий блок продолжает заполняться
+            destination = blocks_.emplace_back(std::make_unique<char[]>(text.size())).get();
+            reserved_bytes_ += text.size();
+        }
+        else {
+            if (current_left_ < text.size()) {
+                current_ = blocks_.emplace_back(std::make_unique<char[]>(block_size_)).get();
+                current_left_ = block_size_;
+                reserved_bytes_ += block_size_;
+            }
+            destination = current_;
+            current_ += text.size();
+            current_left_ -= text.size();
+        }
+
+        std::memcpy(destination, text.data(), text.size());
+        return { destination, text.size() };
+    }
+
+    size_t StringArena::GetStringCount() const {
+        return string_count_;
+    }
+
+    size_t StringArena::GetStoredBytes() const {
+        return stored_bytes_;
+    }
+
+    size_t StringArena::GetReservedBytes() const {
+        return reserved_bytes_;
+    }
+
+} // namespace trans_cat
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace trans_cat {
+
+    /**
+     * @brief Хранилище строк только на добавление.
+     *
+     * Строки копируются подряд в крупные блоки; возвращаемые string_view остаются
+     * валидными, пока жив арена-владелец (в том числе после её перемещения —
+     * блоки не перевыделяются). Отдельные строки не освобождаются.
+     *
+     * Используется каталогом для имён остановок и маршрутов: каждое имя хранится
+     * в одном экземпляре, а Stop, Route, индексы и маршрутизатор ссылаются на него.
+     *
+     * @note Сравнение с std::string на имя: 32 байта объекта + отдельное выделение
+     *       для имён длиннее 15 символов против длины самого имени.
+     */
+    class StringArena {
+    public:
+        /// Размер блока по умолчанию (строки длиннее четверти блока получают свой блок)
+        static constexpr size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+
+        explicit StringArena(size_t block_size = DEFAULT_BLOCK_SIZE);
+
+        StringArena(const StringArena&) = delete;
+        StringArena& operator=(const StringArena&) = delete;
+        StringArena(StringArena&&) noexcept = default;
+        StringArena& operator=(StringArena&&) noexcept = default;
+
+        /// Копирует строку в арену и возвращает указывающий на копию string_view
+        std::string_view Store(std::string_view text);
+
+        /// Число сохранённых строк
+        size_t GetStringCount() const;
+
+        /// Суммарная длина сохранённых строк, байт
+        size_t GetStoredBytes() const;
+
+        /// Память, выделенная под блоки, байт
+        size_t GetReservedBytes() const;
+
+    private:
+        size_t block_size_;
+        std::vector<std::unique_ptr<char[]>> blocks_;
+        char* current_ = nullptr;       ///< Свободное место в текущем общем блоке
+        size_t current_left_ = 0;
+        size_t string_count_ = 0;
+        size_t stored_bytes_ = 0;
+        size_t reserved_bytes_ = 0;
+    };
+
+} // namespace trans_cat
@@ -0,0 +1,161 @@
+#include "text_input_parser.h"
+
+#include <algorithm>
+#include <charconv>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+	using namespace std::string_view_literals;
+
+	// Пробельный символ в смысле \s регулярных выражений
+	bool IsSpace(char c) {
+		return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r';
+	}
+
+	bool IsDigit(char c) {
+		return c >= '0' && c <= '9';
+	}
+
+	// Символ конца строки: '.' регулярного выражения его не принимает
+	bool HasLineBreak(std::string_view text) {
+		return text.find_first_of("\r\n"sv) != text.npos;
+	}
+
+	size_t SkipDigits(std::string_view text, size_t pos) {
+		while (pos < text.size() && IsDigit(text[pos])) {
+			++pos;
+		}
+		return pos;
+	}
+
+	/*
+	 * Читает число вида [+-]?\d*\.?\d+ с позиции pos и сдвигает pos за него.
+	 * Возвращает false, если числа такого вида с pos не начинается.
+	 */
+	bool ReadCoordinate(std::string_view text, size_t& pos, double& value) {
+		size_t end = pos;
+		if (end < text.size() && (text[end] == '+' || text[end] == '-')) {
+			++end;
+		}
+		const size_t integer_end = SkipDigits(text, end);
+		size_t number_end = integer_end;
+		if (integer_end < text.size() && text[integer_end] == '.') {
+			const size_t fraction_end = SkipDigits(text, integer_end + 1);
+			if (fraction_end > integer_end + 1) {
+				number_end = fraction_end;
+			}
+		}
+		if (number_end == integer_end && integer_end == end) {
+			return false;  // Ни одной цифры
+		}
+
+		// from_chars не принимает ведущий '+'
+		const char* first = text.data() + pos + (text[pos] == '+' ? 1 : 0);
+		const auto [ptr, error] = std::from_chars(first, text.data() + number_end, value);
+		if (error != std::errc{} || ptr != text.data() + number_end) {
+			throw std::invalid_argument("Invalid coordinates in stop data");
+		}
+		pos = number_end;
+		return true;
+	}
+
+	size_t SkipSpaces(std::string_view text, size_t pos) {
+		while (pos < text.size() && IsSpace(text[pos])) {
+			++pos;
+		}
+		return pos;
+	}
+
+} // namespace
+
+CommandDescription ParseCommandDescription(std::string_view line) {
+	static constexpr std::pair<std::string_view, std::string_view> commands[]{
+		{ "Stop "sv, "Stop"sv },
+		{ "Bus "sv, "Bus"sv } };
+
+	for (const auto& [prefix, command] : commands) {
+		if (line.substr(0, prefix.size()) != prefix) {
+			continue;
+		}
+
+		// Имя не содержит ':' — заканчивается на первом двоеточии; внутри допустимы только пробелы
+		const std::string_view rest = line.substr(prefix.size());
+		const size_t colon = rest.find(':');
+		if (colon == rest.npos || colon == 0 || rest[0] == ' ' || colon + 1 >= rest.size() || rest[colon + 1] != ' ') {
+			return {};
+		}
+		const std::string_view id = rest.substr(0, colon);
+		for (char c : id) {
+			if (c != ' ' && IsSpace(c)) {
+				return {};
+			}
+		}
+		const std::string_view description = rest.substr(colon + 2);
+		if (HasLineBreak(description)) {
+			return {};
+		}
+
+		CommandDescription result;
+		result.command = command;
+		result.id = id;
+		result.description = description;
+		return result;
+	}
+
+	return {};
+}
+
+StopData ParseStopData(std::string_view str) {
+	StopData stop_data;
+
+	// Координаты: "<широта>,<пробелы><долгота>", затем конец строки или ",<пробелы><расстояния>"
+	size_t pos = 0;
+	if (!ReadCoordinate(str, pos, stop_data.coordinates.lat) || pos >= str.size() || str[pos] != ',') {
+		throw std::invalid_argument("Invalid stop data format");
+	}
+	pos = SkipSpaces(str, pos + 1);
+	if (!ReadCoordinate(str, pos, stop_data.coordinates.lng)) {
+		throw std::invalid_argument("Invalid stop data format");
+	}
+	if (pos == str.size()) {
+		return stop_data;
+	}
+	if (str[pos] != ',') {
+		throw std::invalid_argument("Invalid stop data format");
+	}
+	const std::string_view remaining = str.substr(SkipSpaces(str, pos + 1));
+	if (HasLineBreak(remaining)) {
+		throw std::invalid_argument("Invalid stop data format");
+	}
+
+	// Расстояния: "<цифры>m to <имя до запятой>" в любом месте остатка, слева направо.
+	// Если за серией цифр нет "m to <имя>", то его нет и за любым её хвостом — пропускаем серию
+	static constexpr std::string_view marker = "m to "sv;
+	pos = 0;
+	while (pos < remaining.size()) {
+		if (!IsDigit(remaining[pos])) {
+			++pos;
+			continue;
+		}
+		const size_t digits_end = SkipDigits(remaining, pos);
+		const size_t name_begin = digits_end + marker.size();
+		if (remaining.substr(digits_end, marker.size()) != marker
+			|| name_begin >= remaining.size() || remaining[name_begin] == ',') {
+			pos = digits_end;
+			continue;
+		}
+
+		int distance = 0;
+		const auto [ptr, error] = std::from_chars(remaining.data() + pos, remaining.data() + digits_end, distance);
+		if (error != std::errc{}) {
+			throw std::out_of_range("Distance is out of range");
+		}
+		const size_t name_end = std::min(remaining.find(',', name_begin), remaining.size());
+		stop_data.nearby_stops.emplace(std::string(remaining.substr(name_begin, name_end - name_begin)), distance);
+		pos = name_end;
+	}
+
+	return stop_data;
+}
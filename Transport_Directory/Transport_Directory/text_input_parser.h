@@ -0,0 +1,63 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "geo.h"
+
+/*
+ * Разбор строк текстового формата базы (InputReader):
+ *     Stop <имя>: <широта>, <долгота>[, <D>m to <остановка>, ...]
+ *     Bus <имя>: <A> > <B> > <A>   или   <A> - <B> - <C>
+ *
+ * Основные функции разбирают строку за один проход по string_view без регулярных
+ * выражений; память выделяется только под поля результата. Они принимают и
+ * отвергают ровно те же строки и дают тот же результат, что и прежний разбор
+ * регулярными выражениями — он сохранён в bench/regex_text_parser.h
+ * для сравнения (bench/benchmark.cpp, --text-lines).
+ */
+
+/*
+ * Структура CommandDescription - хранение данных разобранной команды
+ */
+struct CommandDescription {
+	// Определяет, задана ли команда (поле command непустое)
+	explicit operator bool() const {
+		return !command.empty();
+	}
+
+	bool operator!() const {
+		return !operator bool();
+	}
+
+	std::string command{};		// Название команды
+	std::string id{};			// id маршрута или остановки
+	std::string description{};	// Параметры команды
+	std::string distances{};	// Для команд Stop - расстояния до соседних остановок
+};
+
+/*
+ * Структура StopData - передача данных остановки из функции парсинга команды добавления остановки
+ * в методы добавления остановки в справочник и другие функции, использующие данные парсинга
+ */
+struct StopData {
+	geo::Coordinates coordinates{ 0.0, 0.0 };				// Географические координаты остановки
+	std::unordered_map<std::string, int> nearby_stops{};	// Расстояния до соседних остановок
+};
+
+/*
+ * Разбирает строку команды "Stop"/"Bus": имя — до первого ':' (без табуляций и
+ * ведущего пробела), за ним обязателен пробел, остальное — description.
+ * Для строки другого вида возвращает пустую CommandDescription.
+ */
+CommandDescription ParseCommandDescription(std::string_view line);
+
+/*
+ * Разбирает description команды Stop: координаты и расстояния "Dm to <имя>"
+ * (имя — до запятой). При повторе имени действует первое расстояние.
+ *
+ * @throws std::invalid_argument Если формат данных некорректен или координаты не могут быть преобразованы
+ * @throws std::out_of_range Если расстояние не помещается в int
+ */
+StopData ParseStopData(std::string_view str);
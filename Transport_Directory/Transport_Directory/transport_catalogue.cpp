@@ -2,32 +2,31 @@
 #include "geo.h"
 #include <cmath>
 #include <algorithm>
+#include <stdexcept>
+#include <utility>
 
 namespace trans_cat {
 
-    // Хэш для пары указателей
-    size_t TransportCatalogue::PairHash::operator()(
-        const std::pair<const Stop*, const Stop*>& p) const {
-        size_t seed = 0;
-        hash_combine(seed, p.first);
-        hash_combine(seed, p.second);
-        return seed;
-    }
-
     const Stop* TransportCatalogue::AddStop(std::string_view name, geo::Coordinates coords) {
+        CheckNotFrozen();
         if (auto* stop = FindStop(name)) {
-            const_cast<Stop*>(stop)->coordinates = coords;
+            auto* mutable_stop = const_cast<Stop*>(stop);
+            mutable_stop->coordinates = coords;
+            mutable_stop->position = geo::ToUnitVector(coords);
+            NotifyChange({ .type = CatalogueChange::Type::StopMoved, .stop = stop });
             return stop;
         }
 
-        stops_.push_back(Stop{ std::string(name), coords });
+        stops_.push_back(Stop{ names_.Store(name), coords, geo::ToUnitVector(coords), static_cast<uint32_t>(stops_.size()) });
         const Stop* stop_ptr = &stops_.back();
         stopname_to_stop_[stop_ptr->name] = stop_ptr;
+        NotifyChange({ .type = CatalogueChange::Type::StopAdded, .stop = stop_ptr });
         return stop_ptr;
     }
 
-    void TransportCatalogue::AddRoute(std::string& name, const std::vector<std::string>& stop_names,
+    void TransportCatalogue::AddRoute(std::string_view name, const std::vector<std::string>& stop_names,
         bool is_roundtrip) {
+        CheckNotFrozen();
         if (stop_names.empty()) {
             return;
         }
@@ -53,18 +52,123 @@ namespace trans_cat {
             }
         }
 
+        // Маршрут с тем же именем заменяется целиком
+        RemoveRoute(name);
+
         // Создаём маршрут
-        routes_.emplace_back(Route{ std::move(name), std::move(stop_ptrs), is_roundtrip });
+        routes_.emplace_back(Route{ names_.Store(name), std::move(stop_ptrs), is_roundtrip });
         const Route* route_ptr = &routes_.back();
         routename_to_route_[route_ptr->name] = route_ptr;
 
         // Обновляем индекс: остановка → маршрут
         for (const Stop* stop : route_ptr->stops) {
-            stop_to_routes_[stop].insert(route_ptr);
+            stop_to_routes_.Add(stop->id, route_ptr);
+        }
+
+        NotifyChange({ .type = CatalogueChange::Type::RouteAdded, .route = route_ptr });
+    }
+
+    bool TransportCatalogue::RemoveRoute(std::string_view name) {
+        CheckNotFrozen();
+        const Route* route = FindRoute(name);
+        if (!route) {
+            return false;
+        }
+
+        // Объект маршрута остаётся в routes_ (указатели на него валидны), удаляем только из индексов
+        for (const Stop* stop : route->stops) {
+            stop_to_routes_.Remove(stop->id, route);
+        }
+        routename_to_route_.erase(route->name);
+
+        NotifyChange({ .type = CatalogueChange::Type::RouteRemoved, .route = route });
+        return true;
+    }
+
+    struct ChangeListenerList {
+        uint64_t next_id = 1;
+        std::vector<std::pair<uint64_t, ChangeListener>> listeners;  ///< В порядке подписки
+    };
+
+    ChangeSubscription::ChangeSubscription(std::weak_ptr<ChangeListenerList> listeners, uint64_t id)
+        : listeners_(std::move(listeners))
+        , id_(id) {
+    }
+
+    ChangeSubscription::ChangeSubscription(ChangeSubscription&& other) noexcept
+        : listeners_(std::move(other.listeners_))
+        , id_(std::exchange(other.id_, 0)) {
+    }
+
+    ChangeSubscription& ChangeSubscription::operator=(ChangeSubscription&& other) noexcept {
+        if (this != &other) {
+            Reset();
+            listeners_ = std::move(other.listeners_);
+            id_ = std::exchange(other.id_, 0);
+        }
+        return *this;
+    }
+
+    ChangeSubscription::~ChangeSubscription() {
+        Reset();
+    }
+
+    void ChangeSubscription::Reset() {
+        if (auto list = listeners_.lock()) {
+            std::erase_if(list->listeners, [this](const auto& entry) { return entry.first == id_; });
+        }
+        listeners_.reset();
+        id_ = 0;
+    }
+
+    ChangeSubscription TransportCatalogue::AddChangeListener(ChangeListener listener) const {
+        if (!change_listeners_) {
+            change_listeners_ = std::make_shared<ChangeListenerList>();
+        }
+        const uint64_t id = change_listeners_->next_id++;
+        change_listeners_->listeners.emplace_back(id, std::move(listener));
+        return ChangeSubscription(change_listeners_, id);
+    }
+
+    void TransportCatalogue::NotifyChange(const CatalogueChange& change) {
+        ++change_version_;
+        if (!change_listeners_) {
+            return;
+        }
+        for (const auto& [id, listener] : change_listeners_->listeners) {
+            listener(change);
+        }
+    }
+
+    void TransportCatalogue::Freeze() {
+        if (!frozen_) {
+            frozen_stops_ = FrozenNameIndex<Stop>(stopname_to_stop_);
+            frozen_routes_ = FrozenNameIndex<Route>(routename_to_route_);
+            stop_search_ = StopNameIndex(stopname_to_stop_);
+            distances_.Compact(stops_.size());
+            stop_to_routes_.Compact(stops_.size());
+        }
+        frozen_ = true;
+    }
+
+    bool TransportCatalogue::IsFrozen() const {
+        return frozen_;
+    }
+
+    uint64_t TransportCatalogue::GetChangeVersion() const {
+        return change_version_;
+    }
+
+    void TransportCatalogue::CheckNotFrozen() const {
+        if (frozen_) {
+            throw std::logic_error("TransportCatalogue is frozen");
         }
     }
 
     const Stop* TransportCatalogue::FindStop(std::string_view name) const {
+        if (frozen_) {
+            return frozen_stops_.Find(name);
+        }
         auto it = stopname_to_stop_.find(name);
         return (it != stopname_to_stop_.end()) ? it->second : nullptr;
     }
@@ -73,13 +177,28 @@ namespace trans_cat {
         return stopname_to_stop_;
     }
 
+    const StringArena& TransportCatalogue::GetNameArena() const {
+        return names_;
+    }
+
     const Route* TransportCatalogue::FindRoute(std::string_view name) const {
+        if (frozen_) {
+            return frozen_routes_.Find(name);
+        }
         auto it = routename_to_route_.find(name);
         return (it != routename_to_route_.end()) ? it->second : nullptr;
     }
 
     bool TransportCatalogue::StopExists(std::string_view name) const {
-        return stopname_to_stop_.contains(name);
+        return FindStop(name) != nullptr;
+    }
+
+    std::vector<StopMatch> TransportCatalogue::SearchStops(std::string_view query, size_t limit,
+        size_t max_distance) const {
+        if (frozen_) {
+            return stop_search_.Search(query, limit, max_distance);
+        }
+        return StopNameIndex(stopname_to_stop_).Search(query, limit, max_distance);
     }
 
     std::vector<const Route*> TransportCatalogue::GetRoutesSortedByName() const {
@@ -104,9 +223,12 @@ namespace trans_cat {
         std::vector<const Route*> result;
         result.reserve(routes_.size());
 
-        // Бежим по deque — он хранит элементы в порядке добавления
+        // Бежим по deque — он хранит элементы в порядке добавления.
+        // Удалённые (или заменённые) маршруты в индексе отсутствуют — пропускаем их
         for (const Route& route : routes_) {
-            result.push_back(&route);
+            if (FindRoute(route.name) == &route) {
+                result.push_back(&route);
+            }
         }
 
         return result;
@@ -135,31 +257,34 @@ namespace trans_cat {
         stat.unique_stop_count = unique_stops.size();
 
         // Длина маршрута и прямое расстояние
-        double route_length_direct = 0.0;
         double route_length = 0.0;
 
         // Считаем длину в прямом направлении
         const Stop* prev_stop = nullptr;
-        geo::Coordinates prev_coords;
+
+        // Буфер координат переиспользуется между вызовами: после прогрева память не выделяется
+        thread_local geo::PathCoordinates path;
+        path.Clear();
+        path.Reserve(route->stops.size());
 
         for (const Stop* stop : route->stops) {
             if (prev_stop) {
                 route_length += GetDistance(prev_stop, stop);
-                route_length_direct += ComputeDistance(prev_coords, stop->coordinates);
             }
             prev_stop = stop;
-            prev_coords = stop->coordinates;
+            path.Add(stop->position);
         }
 
+        // Расстояние по прямой симметрично — обратный путь равен прямому
+        double route_length_direct = ComputePathLength(path);
+
         // Если маршрут НЕ кольцевой — добавляем обратный путь (без первой остановки)
         if (!route->is_roundtrip && route->stops.size() > 1) {
             // Обратный путь: с предпоследней до первой
             for (size_t i = route->stops.size() - 1; i > 0; --i) {
-                const Stop* from = route->stops[i];
-                const Stop* to = route->stops[i - 1];
-                route_length += GetDistance(from, to);
-                route_length_direct += ComputeDistance(from->coordinates, to->coordinates);
+                route_length += GetDistance(route->stops[i], route->stops[i - 1]);
             }
+            route_length_direct *= 2;
         }
 
         // Финализируем возвращаемое значение
@@ -172,23 +297,17 @@ namespace trans_cat {
         return stat;
     }
 
-    const std::set<const Route*, RouteNameLess>& TransportCatalogue::GetBusesByStop(const Stop* stop) const {
-        static const std::set<const Route*, RouteNameLess> empty;
-
+    std::span<const Route* const> TransportCatalogue::GetBusesByStop(const Stop* stop) const {
         if (!stop) {
-            return empty;
+            return {};
         }
 
-        auto it = stop_to_routes_.find(stop);
-        if (it == stop_to_routes_.end()) {
-            return empty;
-        }
-
-        return it->second;
+        return stop_to_routes_.Find(stop->id);
     }
 
     void TransportCatalogue::SetDistance(std::string_view from_name, std::string_view to_name,
         int distance) {
+        CheckNotFrozen();
         const Stop* from = FindStop(from_name);
         const Stop* to = FindStop(to_name);
 
@@ -198,7 +317,8 @@ namespace trans_cat {
         }
 
         if (from && to) {
-            distances_[{from, to}] = distance;
+            distances_.Set(from->id, to->id, distance);
+            NotifyChange({ .type = CatalogueChange::Type::DistanceChanged, .stop = from, .to_stop = to });
         }
     }
 
@@ -207,18 +327,15 @@ namespace trans_cat {
             return 0;
         }
 
-        auto it = distances_.find({ from, to });
-        if (it != distances_.end()) {
-            return it->second;
+        if (auto distance = distances_.Find(from->id, to->id)) {
+            return *distance;
         }
-
-        auto r_it = distances_.find({ to, from });
-        if (r_it != distances_.end()) {
-            return r_it->second;
+        if (auto distance = distances_.Find(to->id, from->id)) {
+            return *distance;
         }
 
         // По умолчанию - расстояние по прямой (fallback)
-        return static_cast<int>(std::round(ComputeDistance(from->coordinates, to->coordinates)));
+        return static_cast<int>(std::round(ComputeDistance(from->position, to->position)));
     }
 
 } // namespace trans_cat
@@ -1,19 +1,79 @@
 #pragma once
 
 #include "domain.h"
+#include "string_arena.h"
+#include "frozen_name_index.h"
+#include "stop_name_index.h"
+#include "distance_table.h"
+#include "stop_route_index.h"
 #include <unordered_map>
 #include <unordered_set>
 #include <set>
+#include <cstdint>
+#include <span>
 #include <optional>
 #include <deque>
+#include <functional>
+#include <memory>
 
 namespace trans_cat {
 
-	// Компаратор для сортировки маршрутов по наименованию
-	struct RouteNameLess {
-		bool operator()(const Route* lhs, const Route* rhs) const {
-			return lhs->name < rhs->name;
-		}
+	/**
+	 * @brief Событие изменения каталога.
+	 *
+	 * Передаётся подписчикам (см. TransportCatalogue::AddChangeListener) после
+	 * того, как изменение применено. Позволяет зависимым подсистемам (например,
+	 * маршрутизатору) обновлять только затронутые данные.
+	 */
+	struct CatalogueChange {
+		enum class Type {
+			StopAdded,          ///< Добавлена новая остановка (stop)
+			StopMoved,          ///< Изменились координаты остановки (stop)
+			RouteAdded,         ///< Добавлен маршрут (route)
+			RouteRemoved,       ///< Маршрут удалён из индексов (route — объект ещё жив)
+			DistanceChanged     ///< Изменилось расстояние stop → to_stop
+		};
+
+		Type type;
+		const Stop* stop = nullptr;     ///< Остановка (для DistanceChanged — начальная)
+		const Stop* to_stop = nullptr;  ///< Конечная остановка (только DistanceChanged)
+		const Route* route = nullptr;   ///< Маршрут (RouteAdded, RouteRemoved)
+	};
+
+	/// Обработчик событий изменения каталога
+	using ChangeListener = std::function<void(const CatalogueChange&)>;
+
+	// Список подписчиков каталога (определён в transport_catalogue.cpp)
+	struct ChangeListenerList;
+
+	/**
+	 * @brief Подписка на изменения каталога (см. TransportCatalogue::AddChangeListener).
+	 *
+	 * Владеет подпиской: обработчик отписывается в деструкторе или Reset.
+	 * Подписка не продлевает жизнь каталога — если каталог уничтожен раньше,
+	 * отписка ничего не делает. Перемещение каталога подписку не нарушает.
+	 */
+	class ChangeSubscription {
+	public:
+		ChangeSubscription() = default;
+
+		ChangeSubscription(ChangeSubscription&& other) noexcept;
+		ChangeSubscription& operator=(ChangeSubscription&& other) noexcept;
+		ChangeSubscription(const ChangeSubscription&) = delete;
+		ChangeSubscription& operator=(const ChangeSubscription&) = delete;
+
+		~ChangeSubscription();
+
+		/// Отписывает обработчик (повторный вызов ничего не делает)
+		void Reset();
+
+	private:
+		friend class TransportCatalogue;
+
+		ChangeSubscription(std::weak_ptr<ChangeListenerList> listeners, uint64_t id);
+
+		std::weak_ptr<ChangeListenerList> listeners_;
+		uint64_t id_ = 0;
 	};
 
 	/**
@@ -25,6 +85,7 @@ namespace trans_cat {
 	 * - Получения статистики по маршрутам
 	 * - Поиска остановок и маршрутов
 	 * - Определения маршрутов, проходящих через остановку
+	 * - Оповещения подписчиков об изменениях (CatalogueChange)
 	 *
 	 * Все методы потоконебезопасны.
 	 */
@@ -56,11 +117,57 @@ namespace trans_cat {
 		 *
 		 * Маршрут задаётся списком названий остановок.
 		 * Если остановки ещё не добавлены — они должны быть добавлены автоматически (без координат).
+		 * Если маршрут с таким именем уже есть — он заменяется (старый удаляется через RemoveRoute).
 		 * @param name Название маршрута
 		 * @param stops Список названий остановок в порядке следования
 		 * @param is_roundtrip true, если маршрут кольцевой (без обратного пути)
 		 */
-		void AddRoute(std::string& name, const std::vector<std::string>& stops, bool is_roundtrip);
+		void AddRoute(std::string_view name, const std::vector<std::string>& stops, bool is_roundtrip);
+
+		/**
+		 * @brief Удаляет маршрут из каталога.
+		 *
+		 * Маршрут исключается из всех индексов, но сам объект остаётся в хранилище,
+		 * поэтому ранее выданные указатели на него не становятся висячими.
+		 * @param name Название маршрута
+		 * @return true, если маршрут был найден и удалён
+		 */
+		bool RemoveRoute(std::string_view name);
+
+		/**
+		 * @brief Подписывает обработчик на изменения каталога.
+		 *
+		 * Обработчик вызывается синхронно после каждого изменения
+		 * (AddStop, AddRoute, RemoveRoute, SetDistance) и действует, пока жива
+		 * возвращённая подписка. Отписываться из самого обработчика нельзя.
+		 *
+		 * Метод константный: подписка не меняет данных каталога, а подписчики
+		 * константного (например, замороженного) каталога просто не вызываются.
+		 * @param listener Обработчик
+		 * @return Подписка; при её уничтожении обработчик отписывается
+		 */
+		[[nodiscard]] ChangeSubscription AddChangeListener(ChangeListener listener) const;
+
+		/**
+		 * @brief Замораживает каталог: дальнейшие изменения запрещены.
+		 *
+		 * После заморозки AddStop, AddRoute, RemoveRoute и SetDistance бросают
+		 * std::logic_error. Используется для каталогов, которые читаются
+		 * из нескольких потоков (например, в snapshot::Snapshot).
+		 *
+		 * Набор имён после заморозки не меняется, поэтому FindStop, FindRoute
+		 * и StopExists переходят на компактные индексы FrozenNameIndex,
+		 * а SearchStops — на заранее построенный StopNameIndex. Расстояния,
+		 * заданные через SetDistance, переносятся в основной массив DistanceTable,
+		 * а изменения списков маршрутов остановок — в массив StopRouteIndex.
+		 */
+		void Freeze();
+
+		/// Заморожен ли каталог (см. Freeze)
+		bool IsFrozen() const;
+
+		/// Счётчик изменений: растёт на каждое оповещение подписчиков (пакетная загрузка его не меняет)
+		uint64_t GetChangeVersion() const;
 
 		/**
 		 * @brief Ищет остановку по имени (O(1)).
@@ -77,6 +184,12 @@ namespace trans_cat {
 		 */
 		const std::unordered_map<std::string_view, const Stop*>& GetAllStops() const;
 
+		/**
+		 * @brief Возвращает хранилище имён остановок и маршрутов.
+		 * @note Для оценки памяти каталога (число имён, занятые и выделенные байты).
+		 */
+		const StringArena& GetNameArena() const;
+
 		/**
 		 * @brief Ищет маршрут по имени (O(1)).
 		 * @param name Имя маршрута
@@ -86,6 +199,17 @@ namespace trans_cat {
 
 		bool StopExists(std::string_view name) const;
 
+		/**
+		 * @brief Ищет остановки по началу имени или с опечатками.
+		 * @param query Имя остановки, его начало или имя с опечатками
+		 * @param limit Наибольшее число кандидатов
+		 * @param max_distance Допустимое число правок (см. StopNameIndex::Search)
+		 * @return Кандидаты в порядке убывания релевантности
+		 *
+		 * @note У незамороженного каталога индекс строится на каждый вызов — O(N log N).
+		 */
+		std::vector<StopMatch> SearchStops(std::string_view query, size_t limit, size_t max_distance) const;
+
 		/**
 		 * @brief Возвращает все маршруты, отсортированные по алфавиту.
 		 *
@@ -143,16 +267,16 @@ namespace trans_cat {
 		std::optional<RouteStat> GetRouteStat(std::string_view route_name) const;
 
 		/**
-		 * @brief Возвращает ссылку на отсортированный набор маршрутов, проходящих через остановку.
+		 * @brief Возвращает отсортированный список маршрутов, проходящих через остановку.
 		 *
-		 * Метод предоставляет доступ к множеству указателей на маршруты, которые включают указанную остановку.
-		 * Результат отсортирован по имени маршрута (лексикографически) с использованием компаратора RouteNameLess.
+		 * Метод предоставляет доступ к указателям на маршруты, которые включают указанную остановку.
+		 * Результат отсортирован по имени маршрута (лексикографически, как RouteNameLess), без повторов.
 		 *
 		 * @param stop Указатель на остановку (должен быть валидным или nullptr)
-		 * @return const std::set<const Route*, RouteNameLess>& — ссылка на внутреннее множество маршрутов
-		 *         или на статический пустой набор, если остановка равна nullptr или через неё не проходит ни один маршрут.
+		 * @return std::span — представление внутреннего массива маршрутов остановки
+		 *         или пустой span, если остановка равна nullptr или через неё не проходит ни один маршрут.
 		 *
-		 * @note Возвращаемая ссылка остаётся валидной до следующего изменения набора маршрутов
+		 * @note Представление остаётся валидным до следующего изменения набора маршрутов
 		 *       (например, добавления нового маршрута через AddRoute).
 		 * @note Метод не выполняет поиск остановки по имени — ожидается, что указатель уже получен.
 		 * @note Подходит для случаев, когда требуется доступ к объектам маршрутов, а не только к их именам.
@@ -164,12 +288,12 @@ namespace trans_cat {
 		 *     std::cout << route->name << std::endl;
 		 * }
 		 */
-		const std::set<const Route*, RouteNameLess>& GetBusesByStop(const Stop* stop) const;
+		std::span<const Route* const> GetBusesByStop(const Stop* stop) const;
 
 		/**
 		 * @brief Устанавливает дорожное расстояние между двумя остановками.
 		 *
-		 * Расстояние одностороннее: от from до to.
+		 * Расстояние одностороннее: от from до to. Повторный вызов изменяет расстояние.
 		 * @param from Имя начальной остановки
 		 * @param to Имя конечной остановки
 		 * @param distance Расстояние в метрах
@@ -185,6 +309,12 @@ namespace trans_cat {
 		int GetDistance(const Stop* from, const Stop* to) const;
 
 	private:
+		// Пакетный загрузчик заполняет внутренние индексы напрямую
+		friend class CatalogueBuilder;
+
+		// Имена остановок и маршрутов: Stop::name, Route::name и ключи индексов указывают сюда
+		StringArena names_;
+
 		// Хранилища (владеют объектами)
 		std::deque<Stop> stops_;
 		std::deque<Route> routes_;
@@ -193,16 +323,31 @@ namespace trans_cat {
 		std::unordered_map<std::string_view, const Stop*> stopname_to_stop_;
 		std::unordered_map<std::string_view, const Route*> routename_to_route_;
 
-		// Остановка → множество маршрутов, проходящих через неё
-		std::unordered_map<const Stop*, std::set<const Route*, RouteNameLess>> stop_to_routes_;
+		// Остановка (Stop::id) → маршруты, проходящие через неё, отсортированные по имени (CSR)
+		StopRouteIndex stop_to_routes_;
 
-		// Хэшер для пар указателей
-		struct PairHash {
-			size_t operator()(const std::pair<const Stop*, const Stop*>& p) const;
-		};
+		// Дорожные расстояния по номерам остановок: (from, to) → meters
+		DistanceTable distances_;
+
+		// Подписчики на изменения каталога (создаются при первой подписке; подписки держат weak_ptr)
+		mutable std::shared_ptr<ChangeListenerList> change_listeners_;
+
+		// Индексы имён замороженного каталога (строятся в Freeze)
+		FrozenNameIndex<Stop> frozen_stops_;
+		FrozenNameIndex<Route> frozen_routes_;
+		StopNameIndex stop_search_;
+
+		// Запрет изменений (см. Freeze)
+		bool frozen_ = false;
+
+		// Число применённых изменений (см. GetChangeVersion)
+		uint64_t change_version_ = 0;
+
+		// Увеличивает счётчик изменений и оповещает подписчиков
+		void NotifyChange(const CatalogueChange& change);
 
-		// Граф дорожных расстояний: (from, to) → meters
-		std::unordered_map<std::pair<const Stop*, const Stop*>, int, PairHash> distances_;
+		// Бросает std::logic_error, если каталог заморожен
+		void CheckNotFrozen() const;
 	};
 
 	// Вспомогательная функция для комбинирования хэшей (C++17/20)
@@ -1,16 +1,53 @@
 #include "transport_router.h"
+#include "profiler.h"
+#include "parallel.h"
+#include <algorithm>
 #include <cmath>
+#include <iterator>
+#include <numeric>
+#include <stdexcept>
+#include <string>
 
 namespace tr = transport_router;
 
+std::string_view tr::ToString(RoutingStrategy strategy) {
+    switch (strategy) {
+    case RoutingStrategy::AllPairs:
+        return "all_pairs";
+    case RoutingStrategy::PerQuery:
+        return "per_query";
+    case RoutingStrategy::Landmarks:
+        return "landmarks";
+    case RoutingStrategy::Auto:
+        break;
+    }
+    return "auto";
+}
+
+std::optional<tr::RoutingStrategy> tr::ParseRoutingStrategy(std::string_view name) {
+    for (RoutingStrategy strategy : { RoutingStrategy::Auto, RoutingStrategy::AllPairs,
+        RoutingStrategy::PerQuery, RoutingStrategy::Landmarks }) {
+        if (ToString(strategy) == name) {
+            return strategy;
+        }
+    }
+    return std::nullopt;
+}
+
 tr::TransportRouter::TransportRouter(const trans_cat::TransportCatalogue& catalogue)
     : catalogue_(catalogue)
     , graph_(0)
+    , subscription_(catalogue.AddChangeListener([this](const trans_cat::CatalogueChange& change) {
+        ApplyChange(change);
+    }))
 {
 }
 
 void tr::TransportRouter::SetRoutingSettings(RoutingSettings settings) {
+    PROFILE_FUNCTION();
     settings_ = settings;
+    ++version_;
+    stats_ = settings_.collect_stats ? std::make_unique<RoutingStats>() : nullptr;
 
     const auto& stops = catalogue_.GetAllStops();
     graph_ = graph::DirectedWeightedGraph<double>(2 * stops.size());
@@ -18,36 +55,92 @@ void tr::TransportRouter::SetRoutingSettings(RoutingSettings settings) {
     stop_to_wait_vertex_.clear();
     stop_to_bus_vertex_.clear();
     wait_edge_ids_.clear();
+    wait_vertex_to_stop_.assign(2 * stops.size(), nullptr);
 
     size_t vertex_id = 0;
     for (const auto& [name, stop_ptr] : stops) {
-        std::string key(stop_ptr->name);
-        stop_to_wait_vertex_[key] = vertex_id++;
-        stop_to_bus_vertex_[key] = vertex_id++;
+        wait_vertex_to_stop_[vertex_id] = stop_ptr;
+        stop_to_wait_vertex_[stop_ptr->name] = vertex_id++;
+        stop_to_bus_vertex_[stop_ptr->name] = vertex_id++;
     }
 
     BuildGraph();
 }
 
 void tr::TransportRouter::BuildGraph() {
-    bus_edge_buffer_.clear();
+    PROFILE_FUNCTION();
+    edge_data_.clear();
+    route_to_edges_.clear();
+
+    {
+        PROFILE_SCOPE("BuildGraph: edges");
+        AddWaitEdges();
+
+        // Блоки рёбер маршрутов независимы — считаем их параллельно
+        const auto routes = catalogue_.GetRoutesInInsertionOrder();
+        std::vector<std::vector<BusEdge>> blocks(routes.size());
+        parallel::Transform(routes.begin(), routes.end(), blocks.begin(),
+            [this](const trans_cat::Route* route) { return ComputeBusEdges(*route); });
+
+        // Префиксные суммы размеров блоков — ID первого ребра каждого маршрута.
+        // Порядок тот же, что при последовательном добавлении, поэтому и маршруты те же
+        std::vector<graph::EdgeId> first_edge(blocks.size() + 1, graph_.GetEdgeCount());
+        for (size_t i = 0; i < blocks.size(); ++i) {
+            first_edge[i + 1] = first_edge[i] + blocks[i].size();
+        }
 
-    AddWaitEdges();
-    for (const auto& route : catalogue_.GetRoutesInInsertionOrder()) {
-        AddBusEdges(*route);
-    }
+        graph_.ReserveEdges(first_edge.back());
+        edge_data_.reserve(first_edge.back());
+        route_to_edges_.reserve(routes.size());
 
-    // Инициализируем edge_data_ после добавления всех рёбер
-    edge_data_.assign(graph_.GetEdgeCount(), std::nullopt);
+        // Слияние в граф одним проходом
+        for (size_t i = 0; i < blocks.size(); ++i) {
+            auto& edge_ids = route_to_edges_[routes[i]];
+            edge_ids.resize(blocks[i].size());
+            std::iota(edge_ids.begin(), edge_ids.end(), first_edge[i]);
 
-    // Заполняем данные о маршрутах
-    for (const auto& [edge_id, data] : bus_edge_buffer_) {
-        if (edge_id < edge_data_.size()) {
-            edge_data_[edge_id] = data;
+            for (auto& [edge, data] : blocks[i]) {
+                AddEdge(edge, data);
+            }
         }
     }
 
-    router_.emplace(graph_);
+    router_.reset();
+    landmarks_.reset();
+    stale_landmark_changes_ = 0;
+    strategy_ = ChooseStrategy();
+    graph_built_ = true;
+
+    if (strategy_ == RoutingStrategy::AllPairs) {
+        PROFILE_SCOPE("BuildGraph: all-pairs routes");
+        router_.emplace(graph_);
+    }
+    else if (strategy_ == RoutingStrategy::Landmarks) {
+        PROFILE_SCOPE("BuildGraph: landmarks");
+        landmarks_.emplace(graph_, settings_.landmark_count);
+    }
+}
+
+tr::RoutingStrategy tr::TransportRouter::ChooseStrategy() const {
+    const size_t table_bytes = graph::Router<double>::EstimateMemory(graph_.GetVertexCount());
+    const bool fits = table_bytes <= settings_.memory_limit_bytes;
+
+    switch (settings_.strategy) {
+    case RoutingStrategy::AllPairs:
+        if (!fits) {
+            throw std::length_error("All-pairs routing table needs " + std::to_string(table_bytes)
+                + " bytes, memory limit is " + std::to_string(settings_.memory_limit_bytes));
+        }
+        return RoutingStrategy::AllPairs;
+
+    case RoutingStrategy::PerQuery:
+    case RoutingStrategy::Landmarks:
+        return settings_.strategy;
+
+    case RoutingStrategy::Auto:
+        break;
+    }
+    return fits ? RoutingStrategy::AllPairs : RoutingStrategy::Landmarks;
 }
 
 void tr::TransportRouter::AddWaitEdges() {
@@ -55,113 +148,475 @@ void tr::TransportRouter::AddWaitEdges() {
 
     for (const auto& [name, wait_vertex] : stop_to_wait_vertex_) {
         auto bus_vertex = stop_to_bus_vertex_.at(name);
-        auto edge_id = graph_.AddEdge(graph::Edge<double>{
+        auto edge_id = AddEdge(graph::Edge<double>{
             .from = wait_vertex,
                 .to = bus_vertex,
                 .weight = wait_time
-        });
+        }, std::nullopt);
         wait_edge_ids_.insert(edge_id);
     }
 }
 
-void tr::TransportRouter::AddBusEdges(const trans_cat::Route& route) {
+graph::EdgeId tr::TransportRouter::AddEdge(const graph::Edge<double>& edge, std::optional<BusEdgeData> data) {
+    auto edge_id = graph_.AddEdge(edge);
+    edge_data_.push_back(std::move(data));
+    return edge_id;
+}
+
+graph::EdgeId tr::TransportRouter::AddStopVertices(const trans_cat::Stop& stop) {
+    auto wait_vertex = graph_.AddVertex();
+    auto bus_vertex = graph_.AddVertex();
+
+    wait_vertex_to_stop_.resize(graph_.GetVertexCount(), nullptr);
+    wait_vertex_to_stop_[wait_vertex] = &stop;
+    stop_to_wait_vertex_[stop.name] = wait_vertex;
+    stop_to_bus_vertex_[stop.name] = bus_vertex;
+
+    auto edge_id = AddEdge(graph::Edge<double>{
+        .from = wait_vertex,
+            .to = bus_vertex,
+            .weight = static_cast<double>(settings_.bus_wait_time)
+    }, std::nullopt);
+    wait_edge_ids_.insert(edge_id);
+
+    return edge_id;
+}
+
+std::vector<tr::TransportRouter::BusEdge> tr::TransportRouter::ComputeBusEdges(
+    const trans_cat::Route& route) const {
     const auto& stops = route.stops;
+    const size_t stop_count = stops.size();
     const double velocity_m_min = settings_.bus_velocity * 1000.0 / 60.0;
 
+    // Вершины и длины перегонов ищем один раз на остановку, а не на каждую пару:
+    // forward[j] — перегон j-1 → j, backward[j] — перегон j → j-1
+    std::vector<graph::VertexId> bus_vertices(stop_count);
+    std::vector<graph::VertexId> wait_vertices(stop_count);
+    std::vector<int> forward(stop_count, 0);
+    std::vector<int> backward(stop_count, 0);
+
+    for (size_t j = 0; j < stop_count; ++j) {
+        bus_vertices[j] = stop_to_bus_vertex_.at(stops[j]->name);
+        wait_vertices[j] = stop_to_wait_vertex_.at(stops[j]->name);
+        if (j > 0) {
+            forward[j] = catalogue_.GetDistance(stops[j - 1], stops[j]);
+            if (!route.is_roundtrip) {
+                backward[j] = catalogue_.GetDistance(stops[j], stops[j - 1]);
+            }
+        }
+    }
+
+    std::vector<BusEdge> result;
+    const size_t pair_count = stop_count * (stop_count - 1) / 2;
+    result.reserve(route.is_roundtrip ? pair_count : 2 * pair_count);
+
     // Прямой путь: от i до j (j > i)
-    for (size_t i = 0; i < stops.size(); ++i) {
+    for (size_t i = 0; i < stop_count; ++i) {
         double accumulated_distance = 0.0;
 
-        for (size_t j = i + 1; j < stops.size(); ++j) {
-            accumulated_distance += catalogue_.GetDistance(stops[j - 1], stops[j]);
+        for (size_t j = i + 1; j < stop_count; ++j) {
+            accumulated_distance += forward[j];
             double time = accumulated_distance / velocity_m_min;
 
-            auto from = stop_to_bus_vertex_.at(stops[i]->name);
-            auto to = stop_to_wait_vertex_.at(stops[j]->name);
-
-            auto edge_id = graph_.AddEdge(graph::Edge<double>{
-                .from = from,
-                .to = to,
-                .weight = time
-            });
-
-            bus_edge_buffer_.push_back({
-                edge_id,
-                BusEdgeData{.bus_name = route.name, .span_count = j - i}
+            result.push_back(BusEdge{
+                .edge = {
+                    .from = bus_vertices[i],
+                    .to = wait_vertices[j],
+                    .weight = time
+                },
+                .data = BusEdgeData{.bus_name = route.name, .span_count = j - i}
                 });
         }
     }
 
     // Обратный путь: только для некольцевых маршрутов
     if (!route.is_roundtrip) {
-        for (size_t i = 0; i < stops.size(); ++i) {
+        for (size_t i = 0; i < stop_count; ++i) {
             double accumulated_distance = 0.0;
 
             for (size_t j = i; j > 0; --j) {
-                accumulated_distance += catalogue_.GetDistance(stops[j], stops[j - 1]);
+                accumulated_distance += backward[j];
                 double time = accumulated_distance / velocity_m_min;
 
-                auto from = stop_to_bus_vertex_.at(stops[i]->name);
-                auto to = stop_to_wait_vertex_.at(stops[j - 1]->name);
+                result.push_back(BusEdge{
+                    .edge = {
+                        .from = bus_vertices[i],
+                        .to = wait_vertices[j - 1],
+                        .weight = time
+                    },
+                    .data = BusEdgeData{.bus_name = route.name, .span_count = i - j}
+                    });
+            }
+        }
+    }
 
-                auto edge_id = graph_.AddEdge(graph::Edge<double>{
-                    .from = from,
-                    .to = to,
-                    .weight = time
-                });
+    return result;
+}
 
-                bus_edge_buffer_.push_back({
-                    edge_id,
-                    BusEdgeData{.bus_name = route.name, .span_count = i - j}
-                    });
+std::vector<graph::EdgeId> tr::TransportRouter::AddBusEdges(const trans_cat::Route& route) {
+    auto& edge_ids = route_to_edges_[&route];
+    edge_ids.clear();
+
+    for (auto& [edge, data] : ComputeBusEdges(route)) {
+        edge_ids.push_back(AddEdge(edge, std::move(data)));
+    }
+
+    return edge_ids;
+}
+
+std::vector<graph::EdgeId> tr::TransportRouter::RemoveBusEdges(const trans_cat::Route& route) {
+    auto it = route_to_edges_.find(&route);
+    if (it == route_to_edges_.end()) {
+        return {};
+    }
+
+    std::vector<graph::EdgeId> edge_ids = std::move(it->second);
+    route_to_edges_.erase(it);
+
+    for (graph::EdgeId edge_id : edge_ids) {
+        graph_.RemoveEdge(edge_id);
+    }
+
+    return edge_ids;
+}
+
+void tr::TransportRouter::UpdateBusEdges(const trans_cat::Route& route,
+    std::vector<graph::EdgeId>& improved, std::vector<graph::EdgeId>& worsened) {
+    const auto& edge_ids = route_to_edges_.at(&route);
+    const auto bus_edges = ComputeBusEdges(route);
+
+    // Порядок рёбер в ComputeBusEdges неизменен — сопоставляем по позиции
+    for (size_t i = 0; i < edge_ids.size(); ++i) {
+        const double old_weight = graph_.GetEdge(edge_ids[i]).weight;
+        const double new_weight = bus_edges[i].edge.weight;
+
+        if (new_weight < old_weight) {
+            improved.push_back(edge_ids[i]);
+        }
+        else if (old_weight < new_weight) {
+            worsened.push_back(edge_ids[i]);
+        }
+        else {
+            continue;
+        }
+        graph_.SetEdgeWeight(edge_ids[i], new_weight);
+    }
+}
+
+void tr::TransportRouter::ApplyChange(const trans_cat::CatalogueChange& change) {
+    PROFILE_FUNCTION();
+    using Type = trans_cat::CatalogueChange::Type;
+
+    if (!graph_built_) {
+        return;  // Граф ещё не построен — изменения учтутся при построении
+    }
+
+    std::vector<graph::EdgeId> improved;
+    std::vector<graph::EdgeId> worsened;
+
+    // Могли ли сократиться расстояния между прежними вершинами. Новая остановка —
+    // изолированные вершины, исключение рёбер и рост весов расстояния только увеличивают
+    bool shortens_paths = false;
+
+    switch (change.type) {
+    case Type::StopAdded:
+        improved.push_back(AddStopVertices(*change.stop));
+        break;
+
+    case Type::RouteAdded:
+        improved = AddBusEdges(*change.route);
+        shortens_paths = !improved.empty();
+        break;
+
+    case Type::RouteRemoved:
+        worsened = RemoveBusEdges(*change.route);
+        break;
+
+    case Type::StopMoved:
+    case Type::DistanceChanged:
+        // Затронуты маршруты через остановку (для расстояния — через обе остановки)
+        for (const trans_cat::Route* route : catalogue_.GetBusesByStop(change.stop)) {
+            if (change.to_stop
+                && std::find(route->stops.begin(), route->stops.end(), change.to_stop) == route->stops.end()) {
+                continue;
             }
+            UpdateBusEdges(*route, improved, worsened);
         }
+        shortens_paths = !improved.empty();
+        break;
     }
+
+    if (router_.has_value()) {
+        if (settings_.strategy == RoutingStrategy::Auto
+            && graph::Router<double>::EstimateMemory(graph_.GetVertexCount()) > settings_.memory_limit_bytes) {
+            // Сеть выросла за пределы бюджета — отказываемся от таблицы путей
+            router_.reset();
+            strategy_ = RoutingStrategy::Landmarks;
+            landmarks_.emplace(graph_, settings_.landmark_count);
+            shortens_paths = false;  // Ориентиры построены по уже изменённому графу
+        }
+        else {
+            router_->Update(improved, worsened);
+        }
+    }
+    if (strategy_ == RoutingStrategy::Landmarks && shortens_paths) {
+        // Пути могли стать короче — нижние оценки ориентиров больше не допустимы.
+        // Рост весов и исключение рёбер оценки не нарушают: расстояния только растут
+        landmarks_.reset();
+        if (++stale_landmark_changes_ >= LANDMARK_REBUILD_BATCH) {
+            RefreshLandmarks();
+        }
+    }
+    ++version_;
 }
 
-std::optional<tr::RouteInfo> tr::TransportRouter::BuildRoute(std::string_view from, std::string_view to) const {
-    const auto* from_stop = catalogue_.FindStop(from);
-    const auto* to_stop = catalogue_.FindStop(to);
+void tr::TransportRouter::RefreshLandmarks() {
+    if (strategy_ != RoutingStrategy::Landmarks || landmarks_) {
+        return;
+    }
+    PROFILE_FUNCTION();
+    landmarks_.emplace(graph_, settings_.landmark_count);
+    stale_landmark_changes_ = 0;
+}
+
+uint64_t tr::TransportRouter::GetVersion() const {
+    return version_;
+}
+
+tr::RoutingDiagnostics tr::TransportRouter::GetDiagnostics() const {
+    const size_t vertex_count = graph_.GetVertexCount();
+    const size_t edge_count = graph_.GetEdgeCount();
+
+    RoutingDiagnostics result;
+    result.strategy = graph_built_ ? strategy_ : settings_.strategy;
+    result.vertex_count = vertex_count;
+    result.edge_count = edge_count;
+    // Рёбра с данными автобусных рёбер + по списку инцидентности на вершину
+    result.graph_bytes = edge_count * (sizeof(graph::Edge<double>) + sizeof(graph::EdgeId)
+        + sizeof(std::optional<BusEdgeData>))
+        + vertex_count * sizeof(std::vector<graph::EdgeId>);
+    result.all_pairs_bytes = graph::Router<double>::EstimateMemory(vertex_count);
+    // Вес, последнее ребро и признак фиксации на вершину + очередь до E элементов
+    result.per_query_bytes = vertex_count * (sizeof(std::optional<double>) + sizeof(std::optional<graph::EdgeId>) + 1)
+        + edge_count * sizeof(std::pair<double, graph::VertexId>);
+    result.landmark_count = landmarks_ ? landmarks_->GetLandmarks().size() : 0;
+    result.landmark_bytes = graph::LandmarkIndex<double>::EstimateMemory(vertex_count, settings_.landmark_count);
+    result.memory_limit_bytes = settings_.memory_limit_bytes;
+    return result;
+}
+
+const graph::DirectedWeightedGraph<double>& tr::TransportRouter::GetGraph() const {
+    return graph_;
+}
+
+const tr::RoutingStats* tr::TransportRouter::GetStats() const {
+    return stats_.get();
+}
+
+void tr::TransportRouter::RecordQuery(std::string_view from, std::string_view to, const graph::SearchCounters& work,
+    size_t searches, size_t path_edges, std::chrono::steady_clock::time_point start) const {
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    stats_->Record(from, to, QueryStats{
+        .settled = work.settled,
+        .relaxed = work.relaxed,
+        .heap_pushes = work.heap_pushes,
+        .heap_pops = work.heap_pops,
+        .path_edges = path_edges,
+        .time_ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()),
+        .searches = searches
+        });
+}
 
-    if (!router_.has_value()) {
+void tr::TransportRouter::RecordBatch(const std::vector<StopPair>& pairs, const std::vector<size_t>& indices,
+    const std::vector<std::optional<RouteInfo>>& routes, const graph::SearchCounters& work,
+    std::chrono::steady_clock::time_point start) const {
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    const uint64_t elapsed_ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+    const uint64_t batch_size = indices.size();
+
+    // Доля k-й пары: остаток деления достаётся первым парам, сумма долей равна целому
+    auto share = [batch_size](uint64_t total, size_t k) {
+        return total / batch_size + (k < total % batch_size ? 1 : 0);
+    };
+
+    for (size_t k = 0; k < indices.size(); ++k) {
+        const size_t i = indices[k];
+        stats_->Record(pairs[i].first, pairs[i].second, QueryStats{
+            .settled = share(work.settled, k),
+            .relaxed = share(work.relaxed, k),
+            .heap_pushes = share(work.heap_pushes, k),
+            .heap_pops = share(work.heap_pops, k),
+            .path_edges = routes[i] ? routes[i]->segments.size() : 0,
+            .time_ns = share(elapsed_ns, k),
+            .searches = 1,
+            .batch_size = batch_size
+            });
+    }
+}
+
+std::optional<tr::RouteInfo> tr::TransportRouter::BuildRoute(std::string_view from, std::string_view to) const {
+    PROFILE_FUNCTION();
+    if (!graph_built_) {
         return std::nullopt;
     }
 
-    if (!from_stop || !to_stop) {
+    auto vertices = FindWaitVertices({ from, to });
+    if (!vertices) {
         return std::nullopt;
     }
+    if (!stats_) {
+        return BuildRoute((*vertices)[0], (*vertices)[1]);
+    }
 
-    auto from_vertex_it = stop_to_wait_vertex_.find(std::string(from));
-    auto to_vertex_it = stop_to_wait_vertex_.find(std::string(to));
+    const auto start = std::chrono::steady_clock::now();
+    graph::SearchCounters work;
+    auto route = BuildRoute((*vertices)[0], (*vertices)[1], &work);
+    RecordQuery(from, to, work, router_.has_value() ? 0 : 1, route ? route->segments.size() : 0, start);
+    return route;
+}
 
-    if (from_vertex_it == stop_to_wait_vertex_.end() || to_vertex_it == stop_to_wait_vertex_.end()) {
-        return std::nullopt;
+std::vector<std::optional<tr::RouteInfo>> tr::TransportRouter::BuildRoutes(const std::vector<StopPair>& pairs) const {
+    PROFILE_FUNCTION();
+    std::vector<std::optional<RouteInfo>> result(pairs.size());
+    if (!graph_built_) {
+        return result;
+    }
+
+    // Группируем пары по вершине отправления; пары с неизвестными остановками остаются nullopt
+    std::vector<graph::VertexId> targets(pairs.size());
+    std::unordered_map<graph::VertexId, std::vector<size_t>> origin_to_pairs;
+    for (size_t i = 0; i < pairs.size(); ++i) {
+        auto vertices = FindWaitVertices({ pairs[i].first, pairs[i].second });
+        if (!vertices) {
+            continue;
+        }
+        targets[i] = (*vertices)[1];
+        origin_to_pairs[(*vertices)[0]].push_back(i);
+    }
+    std::vector<std::pair<graph::VertexId, std::vector<size_t>>> groups(
+        std::make_move_iterator(origin_to_pairs.begin()), std::make_move_iterator(origin_to_pairs.end()));
+
+    // Группы независимы и пишут в разные элементы result — обрабатываем параллельно
+    parallel::ForEach(groups.begin(), groups.end(), [&](const auto& group) {
+        const auto& [from_vertex, indices] = group;
+
+        // Таблица путей отвечает без поиска, одиночной паре хватает поиска до цели
+        if (router_.has_value() || indices.size() == 1) {
+            for (size_t i : indices) {
+                const auto start = stats_ ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{};
+                graph::SearchCounters work;
+                result[i] = BuildRoute(from_vertex, targets[i], stats_ ? &work : nullptr);
+                if (stats_) {
+                    RecordQuery(pairs[i].first, pairs[i].second, work, router_.has_value() ? 0 : 1,
+                        result[i] ? result[i]->segments.size() : 0, start);
+                }
+            }
+            return;
+        }
+
+        // Один поиск на все цели группы; в статистике каждая пара получает долю его стоимости
+        const auto start = stats_ ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{};
+        graph::ShortestPathTree<double> tree(graph_, from_vertex);
+        for (size_t i : indices) {
+            if (auto route = tree.BuildRoute(targets[i])) {
+                result[i] = MakeRouteInfo(route->weight, route->edges);
+            }
+        }
+        if (stats_) {
+            RecordBatch(pairs, indices, result, tree.GetCounters(), start);
+        }
+    });
+
+    return result;
+}
+
+std::vector<tr::RouteInfo> tr::TransportRouter::BuildAlternativeRoutes(
+    std::string_view from, std::string_view to, size_t count) const {
+    PROFILE_FUNCTION();
+    std::vector<RouteInfo> result;
+    if (!graph_built_ || count == 0) {
+        return result;
+    }
+
+    auto vertices = FindWaitVertices({ from, to });
+    if (!vertices) {
+        return result;
+    }
+    const auto [from_vertex, to_vertex] = std::pair{ (*vertices)[0], (*vertices)[1] };
+
+    // Новым считается маршрут с другой последовательностью автобусов
+    auto is_distinct = [this](const std::vector<graph::EdgeId>& candidate, const auto& accepted) {
+        const auto buses = GetBusSequence(candidate);
+        return std::none_of(accepted.begin(), accepted.end(), [&](const auto& path) {
+            return GetBusSequence(path.edges) == buses;
+        });
+    };
+
+    const auto start = stats_ ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{};
+    const graph::AlternativePathOptions options;
+    size_t searches = 0;
+    graph::SearchCounters work;
+    auto paths = landmarks_
+        ? graph::FindAlternativePaths(graph_, from_vertex, to_vertex, count, options,
+            landmarks_->MakePotential(to_vertex), is_distinct, &searches, &work)
+        : graph::FindAlternativePaths(graph_, from_vertex, to_vertex, count, options,
+            graph::ZeroPotential<double>{}, is_distinct, &searches, &work);
+
+    size_t path_edges = 0;
+    result.reserve(paths.size());
+    for (const auto& path : paths) {
+        path_edges += path.edges.size();
+        result.push_back(MakeRouteInfo(path.weight, path.edges));
+    }
+    if (stats_) {
+        RecordQuery(from, to, work, searches, path_edges, start);
+    }
+    return result;
+}
+
+std::vector<std::string_view> tr::TransportRouter::GetBusSequence(const std::vector<graph::EdgeId>& edges) const {
+    std::vector<std::string_view> buses;
+    for (graph::EdgeId edge_id : edges) {
+        const auto& data = edge_data_[edge_id];
+        if (data && (buses.empty() || buses.back() != data->bus_name)) {
+            buses.push_back(data->bus_name);
+        }
+    }
+    return buses;
+}
+
+std::optional<tr::RouteInfo> tr::TransportRouter::BuildRoute(graph::VertexId from_vertex, graph::VertexId to_vertex,
+    graph::SearchCounters* work) const {
+    if (router_.has_value()) {
+        auto route = router_->BuildRoute(from_vertex, to_vertex);
+        if (!route) {
+            return std::nullopt;
+        }
+        return MakeRouteInfo(route->weight, route->edges);
     }
 
-    auto route = router_->BuildRoute(from_vertex_it->second, to_vertex_it->second);
+    auto route = landmarks_
+        ? graph::FindShortestPath(graph_, from_vertex, to_vertex, landmarks_->MakePotential(to_vertex), work)
+        : graph::FindShortestPath(graph_, from_vertex, to_vertex, graph::ZeroPotential<double>{}, work);
     if (!route) {
         return std::nullopt;
     }
+    return MakeRouteInfo(route->weight, route->edges);
+}
 
+tr::RouteInfo tr::TransportRouter::MakeRouteInfo(double total_time, const std::vector<graph::EdgeId>& edges) const {
     RouteInfo result;
-    result.total_time = route->weight;
+    result.total_time = total_time;
+    result.segments.reserve(edges.size());
 
-    for (graph::EdgeId edge_id : route->edges) {
+    for (graph::EdgeId edge_id : edges) {
+        const auto& edge = graph_.GetEdge(edge_id);
         if (wait_edge_ids_.count(edge_id)) {
             // Wait-ребро: ожидание на остановке
-            auto edge = graph_.GetEdge(edge_id);
-            std::string_view stop_name;
-            for (const auto& [name, vertex] : stop_to_wait_vertex_) {
-                if (vertex == edge.from) {
-                    stop_name = name;
-                    break;
-                }
-            }
-
             result.segments.push_back(RouteSegment{
                 .type = RouteSegment::Type::Wait,
-                .stop_name = std::string(stop_name),
-                .bus_name = "",
+                .stop_name = wait_vertex_to_stop_[edge.from]->name,
+                .bus_name = {},
                 .span_count = 0,
                 .time = static_cast<double>(settings_.bus_wait_time)
                 });
@@ -169,11 +624,10 @@ std::optional<tr::RouteInfo> tr::TransportRouter::BuildRoute(std::string_view fr
         else {
             // Bus-ребро: поездка на автобусе
             const auto& data = edge_data_[edge_id].value();
-            const auto& edge = graph_.GetEdge(edge_id);
 
             result.segments.push_back(RouteSegment{
                 .type = RouteSegment::Type::Bus,
-                .stop_name = "",
+                .stop_name = {},
                 .bus_name = data.bus_name,
                 .span_count = data.span_count,
                 .time = edge.weight
@@ -183,3 +637,86 @@ std::optional<tr::RouteInfo> tr::TransportRouter::BuildRoute(std::string_view fr
 
     return result;
 }
+
+std::optional<std::vector<std::optional<double>>> tr::TransportRouter::ComputeTravelTimes(
+    std::string_view from, const std::vector<std::string_view>& to) const {
+    auto from_vertices = FindWaitVertices({ from });
+    auto to_vertices = FindWaitVertices(to);
+
+    if (!from_vertices || !to_vertices) {
+        return std::nullopt;
+    }
+
+    return ComputeTravelTimes(from_vertices->front(), *to_vertices);
+}
+
+std::optional<tr::TravelTimeMatrix> tr::TransportRouter::ComputeTravelTimes(
+    const std::vector<std::string_view>& from, const std::vector<std::string_view>& to) const {
+    auto from_vertices = FindWaitVertices(from);
+    auto to_vertices = FindWaitVertices(to);
+
+    if (!from_vertices || !to_vertices) {
+        return std::nullopt;
+    }
+
+    // Поиски из разных источников независимы — выполняем их параллельно
+    TravelTimeMatrix result(from_vertices->size());
+    parallel::Transform(
+        from_vertices->begin(), from_vertices->end(), result.begin(),
+        [this, &to_vertices](graph::VertexId source) {
+            return ComputeTravelTimes(source, *to_vertices);
+        });
+
+    return result;
+}
+
+std::optional<std::vector<graph::VertexId>> tr::TransportRouter::FindWaitVertices(
+    const std::vector<std::string_view>& stops) const {
+    std::vector<graph::VertexId> result;
+    result.reserve(stops.size());
+
+    for (std::string_view stop : stops) {
+        auto it = stop_to_wait_vertex_.find(stop);
+        if (it == stop_to_wait_vertex_.end()) {
+            return std::nullopt;
+        }
+        result.push_back(it->second);
+    }
+
+    return result;
+}
+
+std::vector<std::optional<double>> tr::TransportRouter::ComputeTravelTimes(
+    graph::VertexId from, const std::vector<graph::VertexId>& to) const {
+    // Один поиск из источника; сегменты маршрутов не восстанавливаем
+    graph::ShortestPathTree<double> tree(graph_, from);
+
+    std::vector<std::optional<double>> result;
+    result.reserve(to.size());
+    for (graph::VertexId vertex : to) {
+        result.push_back(tree.GetWeight(vertex));
+    }
+
+    return result;
+}
+
+std::optional<std::vector<tr::ReachableStop>> tr::TransportRouter::ComputeIsochrone(
+    std::string_view from, double max_time) const {
+    auto from_vertices = FindWaitVertices({ from });
+    if (!from_vertices) {
+        return std::nullopt;
+    }
+
+    // Ограниченный поиск: дальше бюджета граф не раскрывается
+    graph::ShortestPathTree<double> tree(graph_, from_vertices->front(), max_time);
+
+    // Вершины зафиксированы по неубыванию времени — порядок сохраняется
+    std::vector<ReachableStop> result;
+    for (graph::VertexId vertex : tree.GetSettledVertices()) {
+        if (const trans_cat::Stop* stop = wait_vertex_to_stop_[vertex]) {
+            result.push_back(ReachableStop{ .stop = stop, .time = *tree.GetWeight(vertex) });
+        }
+    }
+
+    return result;
+}
@@ -3,18 +3,71 @@
 #include "transport_catalogue.h"
 #include "graph.h"
 #include "router.h"
+#include "dijkstra.h"
+#include "landmarks.h"
+#include "alternatives.h"
+#include "routing_stats.h"
 
+#include <chrono>
+#include <cstdint>
+#include <memory>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 namespace transport_router {
 
+    /**
+     * @brief Способ поиска маршрутов.
+     *
+     * AllPairs — таблица кратчайших путей между всеми парами вершин (graph::Router):
+     * O(V²) памяти, запрос за O(L). PerQuery — поиск Дейкстры на каждый запрос:
+     * O(V + E) памяти, запрос за O((V + E) log V). Landmarks — поиск A* с эвристикой
+     * ALT (graph::LandmarkIndex): O(K·V) памяти, раскрывает намного меньше вершин.
+     */
+    enum class RoutingStrategy {
+        Auto,       ///< AllPairs, если таблица укладывается в memory_limit_bytes, иначе Landmarks
+        AllPairs,
+        PerQuery,
+        Landmarks
+    };
+
+    /// Имя стратегии для JSON ("auto", "all_pairs", "per_query", "landmarks")
+    std::string_view ToString(RoutingStrategy strategy);
+
+    /// Стратегия по имени; std::nullopt — имя неизвестно
+    std::optional<RoutingStrategy> ParseRoutingStrategy(std::string_view name);
+
+    /// Бюджет памяти таблицы путей по умолчанию (1 ГиБ — около 8 тыс. остановок)
+    inline constexpr size_t DEFAULT_ROUTING_MEMORY_LIMIT = size_t{ 1 } << 30;
+
+    /// Число ориентиров по умолчанию: дальнейшее увеличение почти не сокращает поиск
+    inline constexpr size_t DEFAULT_LANDMARK_COUNT = 8;
+
     struct RoutingSettings {
         int bus_wait_time = 0;        ///< минуты
         double bus_velocity = 0.0;    ///< км/ч
+        RoutingStrategy strategy = RoutingStrategy::Auto;
+        size_t memory_limit_bytes = DEFAULT_ROUTING_MEMORY_LIMIT;  ///< Бюджет таблицы путей
+        size_t landmark_count = DEFAULT_LANDMARK_COUNT;            ///< Число ориентиров (Landmarks)
+        bool collect_stats = false;    ///< Собирать статистику запросов маршрутов (RoutingStats)
+    };
+
+    /// Сведения о выбранной стратегии и оценках памяти
+    struct RoutingDiagnostics {
+        RoutingStrategy strategy = RoutingStrategy::Auto;  ///< Фактическая стратегия (не Auto после построения)
+        size_t vertex_count = 0;
+        size_t edge_count = 0;
+        size_t graph_bytes = 0;         ///< Оценка памяти графа
+        size_t all_pairs_bytes = 0;     ///< Оценка памяти таблицы путей (AllPairs)
+        size_t per_query_bytes = 0;     ///< Оценка памяти одного поиска (PerQuery, Landmarks)
+        size_t landmark_bytes = 0;      ///< Оценка памяти расстояний до ориентиров (Landmarks)
+        size_t landmark_count = 0;
+        size_t memory_limit_bytes = 0;
     };
 
     struct RouteSegment {
@@ -25,11 +78,11 @@ namespace transport_router {
 
         Type type;
 
-        // Для Wait
-        std::string stop_name;
+        // Для Wait (указывает на Stop::name)
+        std::string_view stop_name;
 
-        // Для Bus
-        std::string bus_name;
+        // Для Bus (указывает на Route::name)
+        std::string_view bus_name;
         size_t span_count = 0;  ///< количество перегонов
         double time = 0.0;      ///< время в минутах
     };
@@ -39,8 +92,17 @@ namespace transport_router {
         std::vector<RouteSegment> segments;
     };
 
+    /// Остановка, достижимая в пределах бюджета времени
+    struct ReachableStop {
+        const trans_cat::Stop* stop = nullptr;
+        double time = 0.0;      ///< время в минутах
+    };
+
+    /// Матрица времён в пути: [источник][цель], std::nullopt — цель недостижима
+    using TravelTimeMatrix = std::vector<std::vector<std::optional<double>>>;
+
     struct BusEdgeData {
-        std::string bus_name;
+        std::string_view bus_name;  ///< Указывает на Route::name (маршруты каталога не уничтожаются)
         size_t span_count;
     };
 
@@ -49,26 +111,209 @@ namespace transport_router {
      *
      * Использует graph::DirectedWeightedGraph и graph::Router.
      * Поддерживает ожидание на остановке и поездки на автобусах с учётом времени и перегонов.
+     *
+     * Стратегия поиска (таблица всех пар или поиск на запрос) выбирается при построении
+     * по размеру графа и бюджету памяти из RoutingSettings.
+     *
+     * Маршрутизатор подписан на изменения каталога (на время своей жизни) и после
+     * построения (SetRoutingSettings) обновляется инкрементально (ApplyChange):
+     * меняются только затронутые рёбра и строки таблицы путей. Обработчик ссылается
+     * на маршрутизатор, поэтому маршрутизатор не копируется и не перемещается.
      */
     class TransportRouter {
     public:
+        /// Изменений, делающих ориентиры недопустимыми, до их перестройки в ApplyChange
+        static constexpr size_t LANDMARK_REBUILD_BATCH = 32;
+
         explicit TransportRouter(const trans_cat::TransportCatalogue& catalogue);
+
+        TransportRouter(const TransportRouter&) = delete;
+        TransportRouter& operator=(const TransportRouter&) = delete;
+
+        /**
+         * @brief Строит граф и выбирает стратегию поиска маршрутов.
+         * @throw std::length_error если стратегия AllPairs задана явно,
+         *        а таблица путей не укладывается в memory_limit_bytes
+         */
         void SetRoutingSettings(RoutingSettings settings);
         std::optional<RouteInfo> BuildRoute(std::string_view from, std::string_view to) const;
 
+        /**
+         * @brief Строит до count заметно различающихся маршрутов между остановками.
+         *
+         * Метод штрафов (graph::FindAlternativePaths) с эвристикой ориентиров,
+         * если они построены. Маршруты с одинаковой последовательностью автобусов
+         * (пересадка на тот же автобус не в счёт) считаются одним. Работа на запрос
+         * ограничена graph::AlternativePathOptions: не больше max_searches поисков.
+         *
+         * @return Маршруты по неубыванию времени, первый — оптимальный;
+         *         пусто, если остановка не найдена или маршрута нет
+         */
+        std::vector<RouteInfo> BuildAlternativeRoutes(std::string_view from, std::string_view to, size_t count) const;
+
+        /// Пара остановок (откуда, куда) для пакетного построения маршрутов
+        using StopPair = std::pair<std::string_view, std::string_view>;
+
+        /**
+         * @brief Строит маршруты для набора пар остановок.
+         *
+         * Пары группируются по остановке отправления: для каждой остановки, из которой
+         * запрошено несколько маршрутов, выполняется один поиск (дерево кратчайших путей),
+         * и все её маршруты восстанавливаются по нему. Одиночные пары и стратегия
+         * AllPairs обрабатываются как в BuildRoute. Группы обрабатываются параллельно.
+         * В статистике (collect_stats) каждая пара группы — отдельный запрос с долей общего поиска.
+         *
+         * @return Маршруты в порядке pairs; std::nullopt — как у BuildRoute
+         */
+        std::vector<std::optional<RouteInfo>> BuildRoutes(const std::vector<StopPair>& pairs) const;
+
+        /**
+         * @brief Вычисляет время в пути от одной остановки до нескольких.
+         *
+         * Выполняет один поиск из остановки from и не восстанавливает сегменты маршрутов.
+         * @return Времена в порядке to; std::nullopt — если какая-либо остановка не найдена
+         */
+        std::optional<std::vector<std::optional<double>>> ComputeTravelTimes(
+            std::string_view from, const std::vector<std::string_view>& to) const;
+
+        /**
+         * @brief Вычисляет матрицу времён в пути "многие ко многим".
+         *
+         * По одному поиску на каждый источник; источники обрабатываются параллельно.
+         * @return Матрица [from][to]; std::nullopt — если какая-либо остановка не найдена
+         */
+        std::optional<TravelTimeMatrix> ComputeTravelTimes(
+            const std::vector<std::string_view>& from, const std::vector<std::string_view>& to) const;
+
+        /**
+         * @brief Находит все остановки, достижимые из from не дольше чем за max_time минут.
+         *
+         * Поиск ограничен бюджетом: вершины дальше порога не раскрываются.
+         * @return Остановки по неубыванию времени (первой — сама from);
+         *         std::nullopt — если остановка from не найдена
+         */
+        std::optional<std::vector<ReachableStop>> ComputeIsochrone(
+            std::string_view from, double max_time) const;
+
+        /**
+         * @brief Применяет изменение каталога без полной перестройки графа.
+         *
+         * Добавляет вершины новых остановок, добавляет/исключает рёбра маршрутов,
+         * пересчитывает веса рёбер маршрутов, затронутых изменением расстояния,
+         * и обновляет только затронутую часть таблицы кратчайших путей.
+         * До вызова SetRoutingSettings изменения игнорируются.
+         *
+         * Вызывается подпиской на каталог автоматически. Ориентиры (Landmarks)
+         * остаются допустимыми, если веса только растут или рёбра исключаются;
+         * новые и подешевевшие рёбра делают их недопустимыми. Тогда ориентиры
+         * отбрасываются (поиски идут Дейкстрой) и строятся заново раз
+         * в LANDMARK_REBUILD_BATCH таких изменений или в RefreshLandmarks.
+         *
+         * @param change Событие каталога
+         */
+        void ApplyChange(const trans_cat::CatalogueChange& change);
+
+        /**
+         * @brief Строит ориентиры заново, если изменения сделали их недопустимыми.
+         *
+         * Вызывается после серии изменений каталога, чтобы не ждать
+         * LANDMARK_REBUILD_BATCH изменений. Для других стратегий ничего не делает.
+         */
+        void RefreshLandmarks();
+
+        /**
+         * @brief Версия маршрутизатора.
+         *
+         * Увеличивается при каждом SetRoutingSettings и ApplyChange: результаты,
+         * полученные при разных версиях, могут отличаться (используется как часть ключа кэша).
+         */
+        uint64_t GetVersion() const;
+
+        /// Выбранная стратегия, размеры графа и оценки памяти
+        RoutingDiagnostics GetDiagnostics() const;
+
+        /// Граф маршрутизации (для диагностики и замеров)
+        const graph::DirectedWeightedGraph<double>& GetGraph() const;
+
+        /**
+         * @brief Статистика запросов BuildRoute, BuildRoutes и BuildAlternativeRoutes.
+         * @return nullptr, если сбор выключен (RoutingSettings::collect_stats)
+         */
+        const RoutingStats* GetStats() const;
+
     private:
+        /// Автобусное ребро вместе с данными для восстановления сегмента
+        struct BusEdge {
+            graph::Edge<double> edge;
+            BusEdgeData data;
+        };
+
         void BuildGraph();
+
+        // Выбирает стратегию для графа текущего размера
+        // (std::length_error — если AllPairs задана явно и не укладывается в бюджет)
+        RoutingStrategy ChooseStrategy() const;
+
+        // Автобусы пути по порядку; подряд идущие одинаковые (пересадка на тот же автобус) — один раз
+        std::vector<std::string_view> GetBusSequence(const std::vector<graph::EdgeId>& edges) const;
+
+        // Восстанавливает сегменты маршрута по рёбрам пути
+        RouteInfo MakeRouteInfo(double total_time, const std::vector<graph::EdgeId>& edges) const;
         void AddWaitEdges();
-        void AddBusEdges(const trans_cat::Route& route);
+
+        // Добавляет ребро в граф и его данные в edge_data_
+        graph::EdgeId AddEdge(const graph::Edge<double>& edge, std::optional<BusEdgeData> data);
+
+        // Добавляет вершины новой остановки и её ребро ожидания; возвращает ID ребра
+        graph::EdgeId AddStopVertices(const trans_cat::Stop& stop);
+
+        // Рассчитывает рёбра маршрута (порядок детерминирован)
+        std::vector<BusEdge> ComputeBusEdges(const trans_cat::Route& route) const;
+
+        // Добавляет рёбра маршрута в граф; возвращает их ID
+        std::vector<graph::EdgeId> AddBusEdges(const trans_cat::Route& route);
+
+        // Исключает рёбра маршрута из графа; возвращает их ID
+        std::vector<graph::EdgeId> RemoveBusEdges(const trans_cat::Route& route);
+
+        // Пересчитывает веса рёбер маршрута, распределяя изменённые рёбра по направлению изменения
+        void UpdateBusEdges(const trans_cat::Route& route,
+            std::vector<graph::EdgeId>& improved, std::vector<graph::EdgeId>& worsened);
+
+        // Находит вершины ожидания для списка остановок (nullopt — если хоть одна не найдена)
+        std::optional<std::vector<graph::VertexId>> FindWaitVertices(
+            const std::vector<std::string_view>& stops) const;
+
+        // Маршрут между вершинами ожидания выбранной стратегией; work — счётчики поиска
+        // (для таблицы AllPairs остаются нулевыми)
+        std::optional<RouteInfo> BuildRoute(graph::VertexId from, graph::VertexId to,
+            graph::SearchCounters* work = nullptr) const;
+
+        // Учитывает запрос в stats_ (если сбор включён); start — момент начала запроса
+        void RecordQuery(std::string_view from, std::string_view to, const graph::SearchCounters& work,
+            size_t searches, size_t path_edges, std::chrono::steady_clock::time_point start) const;
+
+        // Учитывает в stats_ пары indices, ответ на которые дал один общий поиск work:
+        // каждая пара — отдельный запрос с равной долей работы и времени поиска
+        void RecordBatch(const std::vector<StopPair>& pairs, const std::vector<size_t>& indices,
+            const std::vector<std::optional<RouteInfo>>& routes, const graph::SearchCounters& work,
+            std::chrono::steady_clock::time_point start) const;
+
+        // Времена от вершины-источника до заданных вершин (один поиск)
+        std::vector<std::optional<double>> ComputeTravelTimes(
+            graph::VertexId from, const std::vector<graph::VertexId>& to) const;
 
         const trans_cat::TransportCatalogue& catalogue_;
         RoutingSettings settings_;
 
         graph::DirectedWeightedGraph<double> graph_;
 
-        // Отображение: остановка → вершина ожидания / посадки
-        std::unordered_map<std::string, graph::VertexId> stop_to_wait_vertex_;
-        std::unordered_map<std::string, graph::VertexId> stop_to_bus_vertex_;
+        // Отображение: остановка → вершина ожидания / посадки (ключи — Stop::name в арене каталога)
+        std::unordered_map<std::string_view, graph::VertexId> stop_to_wait_vertex_;
+        std::unordered_map<std::string_view, graph::VertexId> stop_to_bus_vertex_;
+
+        // Обратное отображение: вершина ожидания → остановка (для вершин посадки — nullptr)
+        std::vector<const trans_cat::Stop*> wait_vertex_to_stop_;
 
         // Множество ID рёбер ожидания
         std::unordered_set<graph::EdgeId> wait_edge_ids_;
@@ -76,10 +321,28 @@ namespace transport_router {
         // Данные для каждого ребра (только для автобусных)
         std::vector<std::optional<BusEdgeData>> edge_data_;
 
-        // Буфер для временного хранения данных до resize
-        std::vector<std::pair<graph::EdgeId, BusEdgeData>> bus_edge_buffer_;
+        // Рёбра каждого маршрута (в порядке ComputeBusEdges) — для инкрементальных обновлений
+        std::unordered_map<const trans_cat::Route*, std::vector<graph::EdgeId>> route_to_edges_;
+
+        // Граф построен (SetRoutingSettings вызван)
+        bool graph_built_ = false;
 
+        // Фактическая стратегия; таблица путей существует только для AllPairs,
+        // ориентиры — только для Landmarks
+        RoutingStrategy strategy_ = RoutingStrategy::Auto;
         mutable std::optional<graph::Router<double>> router_;
+        std::optional<graph::LandmarkIndex<double>> landmarks_;
+
+        // Изменений, после которых ориентиры недопустимы (landmarks_ сброшен), с последней перестройки
+        size_t stale_landmark_changes_ = 0;
+
+        uint64_t version_ = 0;
+
+        // Статистика запросов; nullptr — сбор выключен
+        std::unique_ptr<RoutingStats> stats_;
+
+        // Подписка на изменения каталога (объявлена последней — отписка до разрушения остальных полей)
+        trans_cat::ChangeSubscription subscription_;
     };
 
 } // namespace transport_router
@@ -0,0 +1,1033 @@
+// Нагрузочный тест Transport_Directory на синтетическом городе.
+//
+// Замеряет по отдельности каждую фазу конвейера:
+//   generate → json::Print → json::Load → загрузка каталога (поштучная и пакетная) →
+//   RequestHandler::Create (построение маршрутизатора) → обработка Bus/Stop/Route/Map
+// и выводит время, пропускную способность и пиковый объём памяти (peak RSS).
+// Для каталога дополнительно выводится занятая им куча и расход на имена (арена строк).
+//
+// Отдельно сравнивает поиск маршрута между случайными парами вершин графа:
+// Дейкстра против A* с ориентирами (ALT) — число раскрытых вершин и задержка,
+// и поиск нескольких различающихся путей (метод штрафов) на тех же парах,
+// а также поиск остановки по имени: std::unordered_map против индекса
+// замороженного каталога (FrozenNameIndex), и StopSearch — поиск по началу имени и с опечатками.
+// Чтение дорожных расстояний замеряется на GetRouteStat всех маршрутов и построении графа,
+// длина ломаной geo::ComputePathLength сверяется с поотрезочной суммой geo::ComputeDistance.
+// Разбор текстового формата базы (InputReader): регулярные выражения против разбора за один проход;
+// ответы текстового формата (ParseAndPrintStat, StatWriter) сверяются побайтно с форматированием
+// через поток, в том числе на каталоге, загруженном InputReader из текстового формата.
+// Инкрементальное обновление маршрутизатора сверяется с полной перестройкой после каждого изменения.
+//
+// Сборка (из каталога Transport_Directory):
+//   g++ -std=c++20 -O2 -pthread -o benchmark bench/*.cpp
+//       $(ls Transport_Directory/*.cpp | grep -v main.cpp) -ltbb
+//   (одной командой; -ltbb нужен для std::execution::par в libstdc++,
+//   без TBB — -DTRANSPORT_NO_PARALLEL вместо -ltbb, см. Transport_Directory/parallel.h)
+//
+// Запуск:
+//   ./benchmark --stops 2000 --routes 200 --requests 20000
+//   ./benchmark --stops 500 --emit > city.json    # только сгенерировать вход для main
+//
+// Параметры:
+//   --stops N, --routes N, --min-length N, --max-length N, --roundtrip-share X,
+//   --requests N, --mix BUS:STOP:ROUTE:MAP, --seed N, --no-render, --emit,
+//   --route-queries N (0 — без сравнения поисков), --landmarks K,
+//   --alternatives K (путей на пару в сравнении поисков; 0 — без поиска альтернатив),
+//   --lookups N (0 — без сравнения поиска по имени), --stop-searches N (0 — без замера StopSearch),
+//   --distance-rounds N (0 — без замера чтения расстояний и сверки длины ломаной),
+//   --text-lines N (0 — без сравнения разбора текстового формата),
+//   --stat-requests N (0 — без сверки ответов текстового формата),
+//   --incremental-changes N (0 — без сверки инкрементального обновления),
+//   --incremental-strategy NAME (стратегия маршрутизатора в этой сверке, по умолчанию landmarks)
+
+#include "city_generator.h"
+#include "regex_text_parser.h"
+#include "../Transport_Directory/json_reader.h"
+#include "../Transport_Directory/request_handler.h"
+#include "../Transport_Directory/landmarks.h"
+#include "../Transport_Directory/alternatives.h"
+#include "../Transport_Directory/text_input_parser.h"
+#include "../Transport_Directory/input_reader.h"
+#include "../Transport_Directory/stat_reader.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+namespace {
+
+	using Clock = std::chrono::steady_clock;
+
+	// Пиковый объём резидентной памяти процесса в мегабайтах
+	double PeakRssMb() {
+#ifdef _WIN32
+		PROCESS_MEMORY_COUNTERS counters{};
+		GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters));
+		return static_cast<double>(counters.PeakWorkingSetSize) / (1024.0 * 1024.0);
+#else
+		rusage usage{};
+		getrusage(RUSAGE_SELF, &usage);
+		return static_cast<double>(usage.ru_maxrss) / 1024.0;  // ru_maxrss — в килобайтах
+#endif
+	}
+
+	// Занятая куча процесса в байтах (0, если аллокатор не даёт статистики)
+	size_t HeapInUseBytes() {
+#ifdef __GLIBC__
+		return mallinfo2().uordblks;
+#else
+		return 0;
+#endif
+	}
+
+	/**
+	 * @brief Таблица результатов: одна строка на фазу.
+	 */
+	class Report {
+	public:
+		// Замеряет выполнение func; items/unit — объём работы фазы для расчёта пропускной способности
+		template <typename Func>
+		void Measure(std::string phase, double items, std::string unit, Func&& func) {
+			const double seconds = Time(std::forward<Func>(func));
+			Add(std::move(phase), seconds, items, std::move(unit));
+		}
+
+		// Добавляет строку для фазы, объём работы которой известен только после замера
+		void Add(std::string phase, double seconds, double items, std::string unit) {
+			rows_.push_back(Row{ std::move(phase), seconds, items, std::move(unit), PeakRssMb() });
+		}
+
+		// Время выполнения func в секундах
+		template <typename Func>
+		static double Time(Func&& func) {
+			const auto start = Clock::now();
+			func();
+			return std::chrono::duration<double>(Clock::now() - start).count();
+		}
+
+		void Print(std::ostream& out) const {
+			out << std::left << std::setw(28) << "phase"
+				<< std::right << std::setw(12) << "time, ms"
+				<< std::setw(18) << "throughput"
+				<< std::setw(10) << "unit"
+				<< std::setw(16) << "peak RSS, MB" << '\n';
+
+			for (const Row& row : rows_) {
+				const double throughput = row.seconds > 0 ? row.items / row.seconds : 0.0;
+				out << std::left << std::setw(28) << row.phase
+					<< std::right << std::fixed << std::setprecision(2)
+					<< std::setw(12) << row.seconds * 1000.0
+					<< std::setw(18) << throughput
+					<< std::setw(10) << row.unit
+					<< std::setw(16) << row.peak_rss_mb << '\n';
+			}
+		}
+
+	private:
+		struct Row {
+			std::string phase;
+			double seconds;
+			double items;
+			std::string unit;
+			double peak_rss_mb;
+		};
+
+		std::vector<Row> rows_;
+	};
+
+	struct Options {
+		bench::CityConfig city;
+		bool emit = false;
+		size_t route_queries = 1000;
+		size_t landmark_count = transport_router::DEFAULT_LANDMARK_COUNT;
+		size_t alternatives = 5;
+		size_t lookups = 1'000'000;
+		size_t stop_searches = 10'000;
+		size_t distance_rounds = 20;
+		size_t text_lines = 200'000;
+		size_t stat_requests = 200'000;
+		size_t incremental_changes = 40;
+		transport_router::RoutingStrategy incremental_strategy = transport_router::RoutingStrategy::Landmarks;
+	};
+
+	/// Итоги серии поисков маршрута одним способом
+	struct SearchSummary {
+		std::string name;
+		std::vector<double> latencies_us;   ///< Задержка каждого поиска, мкс
+		size_t settled_total = 0;           ///< Раскрыто вершин за все поиски
+		size_t found = 0;                   ///< Поисков, нашедших путь
+	};
+
+	double Percentile(std::vector<double> values, double share) {
+		if (values.empty()) {
+			return 0.0;
+		}
+		const size_t index = std::min(values.size() - 1, static_cast<size_t>(share * static_cast<double>(values.size())));
+		std::nth_element(values.begin(), values.begin() + index, values.end());
+		return values[index];
+	}
+
+	/**
+	 * @brief Сравнивает Дейкстру и ALT на одних и тех же парах вершин.
+	 *
+	 * Граф строится отдельным маршрутизатором со стратегией PerQuery, чтобы не
+	 * тратить время и память на таблицу всех пар. Веса найденных путей сверяются.
+	 */
+	void CompareRouteSearches(const trans_cat::TransportCatalogue& catalogue, const json::Document& input,
+		const Options& options, Report& report) {
+		auto settings = json_reader::JSONReader::GetRoutingSettings(input);
+		settings.strategy = transport_router::RoutingStrategy::PerQuery;
+		transport_router::TransportRouter router(catalogue);
+		router.SetRoutingSettings(settings);
+		const auto& graph = router.GetGraph();
+		if (graph.GetEdgeCount() == 0) {
+			return;
+		}
+
+		std::unique_ptr<graph::LandmarkIndex<double>> landmarks;
+		report.Measure("landmarks build (K=" + std::to_string(options.landmark_count) + ")",
+			static_cast<double>(graph.GetVertexCount()), "vertices/s", [&] {
+				landmarks = std::make_unique<graph::LandmarkIndex<double>>(graph, options.landmark_count);
+			});
+
+		// Концы пар — начала и концы случайных рёбер: так в выборку не попадают
+		// изолированные вершины остановок, через которые не проходит ни один маршрут
+		std::mt19937_64 rng(options.city.seed);
+		std::uniform_int_distribution<graph::EdgeId> edge(0, graph.GetEdgeCount() - 1);
+		std::vector<std::pair<graph::VertexId, graph::VertexId>> pairs(options.route_queries);
+		for (auto& [from, to] : pairs) {
+			from = graph.GetEdge(edge(rng)).from;
+			to = graph.GetEdge(edge(rng)).to;
+		}
+
+		SearchSummary dijkstra;
+		dijkstra.name = "Dijkstra";
+		SearchSummary alt;
+		alt.name = "ALT";
+		size_t mismatches = 0;
+
+		auto run = [&](SearchSummary& summary, graph::VertexId from, graph::VertexId to, auto&& search) {
+			graph::SearchCounters work;
+			std::optional<double> weight;
+			summary.latencies_us.push_back(Report::Time([&] {
+				if (auto route = search(from, to, work)) {
+					weight = route->weight;
+				}
+			}) * 1e6);
+			summary.settled_total += work.settled;
+			summary.found += weight.has_value();
+			return weight;
+		};
+
+		for (const auto& [from, to] : pairs) {
+			const auto expected = run(dijkstra, from, to, [&](auto f, auto t, graph::SearchCounters& work) {
+				return graph::FindShortestPath(graph, f, t, graph::ZeroPotential<double>{}, &work);
+			});
+			const auto actual = run(alt, from, to, [&](auto f, auto t, graph::SearchCounters& work) {
+				return graph::FindShortestPath(graph, f, t, landmarks->MakePotential(t), &work);
+			});
+			if (expected.has_value() != actual.has_value() || (expected && std::abs(*expected - *actual) > 1e-6)) {
+				++mismatches;
+			}
+		}
+
+		std::cout << "route search: " << graph.GetVertexCount() << " vertices, " << graph.GetEdgeCount()
+			<< " edges, " << pairs.size() << " random pairs, landmarks "
+			<< std::fixed << std::setprecision(2)
+			<< static_cast<double>(landmarks->GetMemoryUsage()) / (1024.0 * 1024.0) << " MB\n";
+		std::cout << std::left << std::setw(12) << "search"
+			<< std::right << std::setw(16) << "settled/query"
+			<< std::setw(12) << "p50, us" << std::setw(12) << "p99, us"
+			<< std::setw(12) << "found" << '\n';
+		for (const SearchSummary* summary : { &dijkstra, &alt }) {
+			const double queries = static_cast<double>(std::max<size_t>(summary->latencies_us.size(), 1));
+			std::cout << std::left << std::setw(12) << summary->name
+				<< std::right << std::setw(16) << static_cast<double>(summary->settled_total) / queries
+				<< std::setw(12) << Percentile(summary->latencies_us, 0.5)
+				<< std::setw(12) << Percentile(summary->latencies_us, 0.99)
+				<< std::setw(12) << summary->found << '\n';
+		}
+		if (mismatches > 0) {
+			std::cout << "WARNING: " << mismatches << " route weights differ between Dijkstra and ALT\n";
+		}
+
+		if (options.alternatives == 0) {
+			return;
+		}
+
+		// Альтернативы с эвристикой ориентиров — как в TransportRouter::BuildAlternativeRoutes
+		std::vector<double> latencies_us;
+		size_t paths_total = 0;
+		size_t searches_total = 0;
+		for (const auto& [from, to] : pairs) {
+			size_t searches = 0;
+			latencies_us.push_back(Report::Time([&] {
+				paths_total += graph::FindAlternativePaths(graph, from, to, options.alternatives,
+					graph::AlternativePathOptions{}, landmarks->MakePotential(to), graph::AnyPathIsDistinct{},
+					&searches).size();
+			}) * 1e6);
+			searches_total += searches;
+		}
+		const double queries = static_cast<double>(std::max<size_t>(pairs.size(), 1));
+		std::cout << "alternatives (K=" << options.alternatives << "): "
+			<< static_cast<double>(paths_total) / queries << " paths/query, "
+			<< static_cast<double>(searches_total) / queries << " searches/query, p50 "
+			<< Percentile(latencies_us, 0.5) << " us, p99 " << Percentile(latencies_us, 0.99) << " us\n";
+	}
+
+	/**
+	 * @brief Сравнивает поиск остановки по имени: словарь каталога против FrozenNameIndex.
+	 *
+	 * Имена запросов — отдельные строки (как имена из JSON-запросов), каждое
+	 * десятое — промах. Каталог должен быть заморожен: тогда FindStop идёт
+	 * через FrozenNameIndex, а GetAllStops — исходный std::unordered_map.
+	 */
+	void CompareNameLookups(const trans_cat::TransportCatalogue& catalogue, const Options& options, Report& report) {
+		const auto& stops = catalogue.GetAllStops();
+		if (stops.empty()) {
+			return;
+		}
+
+		std::vector<std::string> names;
+		names.reserve(stops.size());
+		for (const auto& [name, stop] : stops) {
+			names.emplace_back(name);
+		}
+
+		std::mt19937_64 rng(options.city.seed);
+		std::uniform_int_distribution<size_t> pick(0, names.size() - 1);
+		std::vector<std::string> queries(options.lookups);
+		for (size_t i = 0; i < queries.size(); ++i) {
+			queries[i] = names[pick(rng)];
+			if (i % 10 == 9) {
+				queries[i] += '?';
+			}
+		}
+
+		// Число найденных имён выводится, чтобы компилятор не выбросил поиск
+		size_t map_found = 0;
+		report.Measure("lookup: unordered_map", static_cast<double>(queries.size()), "lookups/s", [&] {
+			for (const std::string& query : queries) {
+				map_found += stops.find(query) != stops.end();
+			}
+		});
+		size_t frozen_found = 0;
+		report.Measure("lookup: FrozenNameIndex", static_cast<double>(queries.size()), "lookups/s", [&] {
+			for (const std::string& query : queries) {
+				frozen_found += catalogue.FindStop(query) != nullptr;
+			}
+		});
+
+		std::cout << "name lookup: " << names.size() << " stops, " << queries.size() << " lookups, found "
+			<< map_found << " / " << frozen_found << '\n';
+		if (map_found != frozen_found) {
+			std::cout << "WARNING: lookup results differ between unordered_map and FrozenNameIndex\n";
+		}
+	}
+
+	/**
+	 * @brief Замеряет StopSearch: запросы по началу имени и с одной опечаткой.
+	 *
+	 * Префикс — первая половина случайного имени, опечатка — удалённый или заменённый
+	 * символ. Число правок — по умолчанию для длины запроса. Каталог должен быть
+	 * заморожен: иначе индекс строится на каждый запрос.
+	 */
+	void MeasureStopSearch(const trans_cat::TransportCatalogue& catalogue, const Options& options, Report& report) {
+		const auto& stops = catalogue.GetAllStops();
+		if (stops.empty()) {
+			return;
+		}
+
+		std::vector<std::string_view> names;
+		names.reserve(stops.size());
+		for (const auto& [name, stop] : stops) {
+			names.push_back(name);
+		}
+
+		std::mt19937_64 rng(options.city.seed);
+		std::uniform_int_distribution<size_t> pick(0, names.size() - 1);
+		std::vector<std::string> prefixes(options.stop_searches);
+		std::vector<std::string> typos(options.stop_searches);
+		for (size_t i = 0; i < options.stop_searches; ++i) {
+			const std::string_view name = names[pick(rng)];
+			prefixes[i] = std::string(name.substr(0, (name.size() + 1) / 2));
+			typos[i] = std::string(names[pick(rng)]);
+			const size_t pos = std::uniform_int_distribution<size_t>(0, typos[i].size() - 1)(rng);
+			if (i % 2 == 0) {
+				typos[i].erase(pos, 1);
+			}
+			else {
+				typos[i][pos] = typos[i][pos] == 'x' ? 'y' : 'x';
+			}
+		}
+
+		size_t found = 0;
+		auto search = [&](const std::vector<std::string>& queries) {
+			for (const std::string& query : queries) {
+				found += !catalogue.SearchStops(query, 10, trans_cat::StopNameIndex::DefaultMaxDistance(query)).empty();
+			}
+		};
+		report.Measure("StopSearch: prefix", static_cast<double>(prefixes.size()), "req/s", [&] { search(prefixes); });
+		report.Measure("StopSearch: typo", static_cast<double>(typos.size()), "req/s", [&] { search(typos); });
+
+		std::cout << "stop search: " << names.size() << " stops, " << 2 * options.stop_searches
+			<< " queries, answered " << found << '\n';
+	}
+
+	/**
+	 * @brief Замеряет чтение дорожных расстояний.
+	 *
+	 * GetRouteStat всех маршрутов (distance_rounds проходов) и построение графа
+	 * маршрутизатором PerQuery (без таблицы всех пар): обе фазы читают расстояние
+	 * каждой пары соседних остановок маршрута.
+	 */
+	void MeasureDistances(const trans_cat::TransportCatalogue& catalogue, const json::Document& input,
+		const Options& options, Report& report) {
+		const auto routes = catalogue.GetRoutesInInsertionOrder();
+		size_t hops = 0;
+		for (const auto* route : routes) {
+			hops += route->stops.empty() ? 0 : route->stops.size() - 1;
+		}
+
+		double total_length = 0.0;
+		report.Measure("GetRouteStat (all routes)", static_cast<double>(routes.size() * options.distance_rounds),
+			"routes/s", [&] {
+				for (size_t round = 0; round < options.distance_rounds; ++round) {
+					for (const auto* route : routes) {
+						total_length += catalogue.GetRouteStat(route->name)->route_length;
+					}
+				}
+			});
+
+		auto settings = json_reader::JSONReader::GetRoutingSettings(input);
+		settings.strategy = transport_router::RoutingStrategy::PerQuery;
+		size_t edges = 0;
+		report.Measure("graph build (PerQuery)", static_cast<double>(routes.size()), "routes/s", [&] {
+			transport_router::TransportRouter router(catalogue);
+			router.SetRoutingSettings(settings);
+			edges = router.GetGraph().GetEdgeCount();
+		});
+
+		std::cout << "distances: " << hops << " route hops, total length " << std::fixed << std::setprecision(0)
+			<< total_length / static_cast<double>(std::max<size_t>(options.distance_rounds, 1))
+			<< " m, graph edges " << edges << '\n';
+	}
+
+	/**
+	 * @brief Сверяет geo::ComputePathLength с суммой geo::ComputeDistance по координатам.
+	 *
+	 * Длина прямого пути каждого маршрута и одной длинной ломаной через все остановки
+	 * (на ней работают полные векторизованные блоки) должна совпадать с поотрезочной
+	 * суммой с относительной точностью 1e-6 (плюс погрешность acos у почти нулевых
+	 * отрезков, см. ниже). Замеряются оба способа.
+	 */
+	void CheckPathLength(const trans_cat::TransportCatalogue& catalogue, const Options& options, Report& report) {
+		std::vector<std::vector<const trans_cat::Stop*>> paths;
+		for (const auto* route : catalogue.GetRoutesInInsertionOrder()) {
+			paths.push_back(route->stops);
+		}
+		paths.emplace_back();
+		for (const auto* route : catalogue.GetRoutesInInsertionOrder()) {
+			paths.back().insert(paths.back().end(), route->stops.begin(), route->stops.end());
+		}
+
+		std::vector<geo::PathCoordinates> coordinates(paths.size());
+		size_t hops = 0;
+		for (size_t i = 0; i < paths.size(); ++i) {
+			for (const auto* stop : paths[i]) {
+				coordinates[i].Add(stop->position);
+			}
+			hops += paths[i].empty() ? 0 : paths[i].size() - 1;
+		}
+
+		std::vector<double> expected(paths.size(), 0.0);
+		std::vector<double> actual(paths.size(), 0.0);
+		const double items = static_cast<double>(hops * options.distance_rounds);
+		report.Measure("geo: ComputeDistance (per hop)", items, "hops/s", [&] {
+			for (size_t round = 0; round < options.distance_rounds; ++round) {
+				for (size_t i = 0; i < paths.size(); ++i) {
+					double length = 0.0;
+					for (size_t j = 1; j < paths[i].size(); ++j) {
+						length += geo::ComputeDistance(paths[i][j - 1]->coordinates, paths[i][j]->coordinates);
+					}
+					expected[i] = length;
+				}
+			}
+		});
+		report.Measure("geo: ComputePathLength (SoA)", items, "hops/s", [&] {
+			for (size_t round = 0; round < options.distance_rounds; ++round) {
+				for (size_t i = 0; i < paths.size(); ++i) {
+					actual[i] = geo::ComputePathLength(coordinates[i]);
+				}
+			}
+		});
+
+		// Оба способа берут acos от косинуса угла, вычисленного с ошибкой в несколько ulp (δ ≈ 4ε).
+		// Ошибка угла — δ / sin θ, но не больше sqrt(2δ) (при θ → 0): для отрезков в сотни метров
+		// это доли миллиметра, для совпадающих или почти совпадающих остановок — до 0.3 м.
+		// Эта неустранимая часть допуска добавляется к относительной точности 1e-6
+		constexpr double DOT_ERROR = 4 * std::numeric_limits<double>::epsilon();
+		auto acos_error = [](double hop) {
+			const double angle = hop / geo::EARTH_RADIUS_METERS;
+			return geo::EARTH_RADIUS_METERS * std::min(std::sqrt(2 * DOT_ERROR), DOT_ERROR / std::max(angle, 1e-300));
+		};
+
+		size_t mismatches = 0;
+		for (size_t i = 0; i < paths.size(); ++i) {
+			double tolerance = 1e-6 * expected[i];
+			for (size_t j = 1; j < paths[i].size(); ++j) {
+				tolerance += acos_error(geo::ComputeDistance(paths[i][j - 1]->coordinates, paths[i][j]->coordinates));
+			}
+			if (std::abs(actual[i] - expected[i]) > tolerance) {
+				++mismatches;
+			}
+		}
+		std::cout << "path length: " << paths.size() << " paths, " << hops << " hops, mismatches " << mismatches << '\n';
+		if (mismatches > 0) {
+			std::cout << "WARNING: ComputePathLength differs from ComputeDistance\n";
+		}
+	}
+
+	/**
+	 * @brief Сверяет инкрементальное обновление маршрутизатора с полной перестройкой.
+	 *
+	 * На изменяемой копии каталога выполняется incremental_changes случайных изменений
+	 * (расстояние между соседними остановками маршрута, удаление и добавление маршрута,
+	 * новая остановка). Маршрутизатор подписан на каталог и обновляется ApplyChange;
+	 * после каждого изменения его ответы на случайные пары сверяются с маршрутизатором,
+	 * построенным заново. Замеряются время изменений (вместе с ApplyChange) и перестроек.
+	 */
+	void CheckIncrementalUpdates(const json::Document& input, const Options& options, Report& report) {
+		trans_cat::TransportCatalogue catalogue;
+		json_reader::JSONReader(catalogue).LoadFromJson(input);
+
+		auto settings = json_reader::JSONReader::GetRoutingSettings(input);
+		settings.strategy = options.incremental_strategy;
+		transport_router::TransportRouter router(catalogue);
+		router.SetRoutingSettings(settings);
+
+		std::vector<std::string> names;
+		for (const auto& [name, stop] : catalogue.GetAllStops()) {
+			names.emplace_back(name);
+		}
+		std::sort(names.begin(), names.end());
+		if (names.size() < 2) {
+			return;
+		}
+
+		std::mt19937 random(static_cast<std::mt19937::result_type>(options.city.seed));
+		auto pick = [&random](size_t size) { return std::uniform_int_distribution<size_t>(0, size - 1)(random); };
+
+		constexpr size_t QUERIES_PER_CHANGE = 50;
+		size_t mismatches = 0;
+		size_t queries = 0;
+		auto compare = [&](const transport_router::TransportRouter& reference) {
+			for (size_t q = 0; q < QUERIES_PER_CHANGE; ++q) {
+				const auto& from = names[pick(names.size())];
+				const auto& to = names[pick(names.size())];
+				const auto actual = router.BuildRoute(from, to);
+				const auto expected = reference.BuildRoute(from, to);
+				++queries;
+				if (actual.has_value() != expected.has_value()
+					|| (actual && std::abs(actual->total_time - expected->total_time) > 1e-6)) {
+					++mismatches;
+				}
+			}
+		};
+
+		double change_seconds = 0.0;
+		double rebuild_seconds = 0.0;
+		for (size_t step = 0; step < options.incremental_changes; ++step) {
+			const auto routes = catalogue.GetRoutesInInsertionOrder();
+			change_seconds += Report::Time([&] {
+				switch (step % 4) {
+				case 0:
+					// Расстояние между соседними остановками маршрута — меняет веса его рёбер
+					if (const auto* route = routes.empty() ? nullptr : routes[pick(routes.size())];
+						route && route->stops.size() > 1) {
+						const size_t i = pick(route->stops.size() - 1);
+						catalogue.SetDistance(route->stops[i]->name, route->stops[i + 1]->name,
+							100 + static_cast<int>(pick(5000)));
+					}
+					break;
+				case 1:
+					if (!routes.empty()) {
+						catalogue.RemoveRoute(routes[pick(routes.size())]->name);
+					}
+					break;
+				case 2: {
+					std::vector<std::string> stops;
+					for (size_t k = 0; k < 5; ++k) {
+						stops.push_back(names[pick(names.size())]);
+					}
+					catalogue.AddRoute("Incremental " + std::to_string(step), stops, step % 8 == 2);
+					break;
+				}
+				default:
+					names.push_back("Incremental stop " + std::to_string(step));
+					catalogue.AddStop(names.back(), { 55.6, 37.4 });
+					break;
+				}
+			});
+
+			transport_router::TransportRouter reference(catalogue);
+			rebuild_seconds += Report::Time([&] { reference.SetRoutingSettings(settings); });
+			compare(reference);
+		}
+
+		// Ориентиры, отброшенные изменениями, строятся заново — ответы не должны измениться
+		const double refresh_seconds = Report::Time([&] { router.RefreshLandmarks(); });
+		{
+			transport_router::TransportRouter reference(catalogue);
+			reference.SetRoutingSettings(settings);
+			compare(reference);
+		}
+
+		const double changes = static_cast<double>(options.incremental_changes);
+		report.Add("incremental: changes", change_seconds, changes, "changes/s");
+		report.Add("incremental: full rebuild", rebuild_seconds, changes, "builds/s");
+		report.Add("incremental: refresh", refresh_seconds, 1.0, "builds/s");
+		std::cout << "incremental (" << transport_router::ToString(settings.strategy) << "): "
+			<< options.incremental_changes << " changes, " << queries << " queries, mismatches " << mismatches << '\n';
+		if (mismatches > 0) {
+			std::cout << "WARNING: incremental router differs from full rebuild\n";
+		}
+	}
+
+	/// Результат разбора строки текстового формата: команда, данные остановки или текст исключения
+	struct ParsedLine {
+		CommandDescription command;
+		StopData stop;
+		std::string error;
+
+		bool operator==(const ParsedLine& other) const {
+			return command.command == other.command.command && command.id == other.command.id
+				&& command.description == other.command.description
+				&& stop.coordinates.lat == other.stop.coordinates.lat && stop.coordinates.lng == other.stop.coordinates.lng
+				&& stop.nearby_stops == other.stop.nearby_stops && error == other.error;
+		}
+	};
+
+	template <typename ParseCommand, typename ParseStop>
+	ParsedLine ParseTextLine(std::string_view line, ParseCommand parse_command, ParseStop parse_stop) {
+		ParsedLine result;
+		try {
+			result.command = parse_command(line);
+			if (result.command.command == "Stop") {
+				result.stop = parse_stop(result.command.description);
+			}
+		}
+		catch (const std::out_of_range&) {
+			result.error = "out of range";  // Текст исключения std::stoi зависит от реализации
+		}
+		catch (const std::exception& e) {
+			result.error = e.what();
+		}
+		return result;
+	}
+
+	/// Строки текстового формата (InputReader) из base_requests JSON; координаты — с precision знаками
+	std::vector<std::string> MakeTextLines(const json::Document& input, int precision = 6) {
+		std::vector<std::string> lines;
+		for (const auto& node : input.GetRoot().AsDict().at("base_requests").AsArray()) {
+			const auto& request = node.AsDict();
+			std::ostringstream line;
+			line << std::fixed << std::setprecision(precision);
+			if (request.at("type").AsString() == "Stop") {
+				line << "Stop " << request.at("name").AsString() << ": "
+					<< request.at("latitude").AsDouble() << ", " << request.at("longitude").AsDouble();
+				for (const auto& [to, meters] : request.at("road_distances").AsDict()) {
+					line << ", " << meters.AsInt() << "m to " << to;
+				}
+			}
+			else {
+				const bool is_roundtrip = request.at("is_roundtrip").AsBool();
+				line << "Bus " << request.at("name").AsString() << ": ";
+				bool first = true;
+				for (const auto& stop : request.at("stops").AsArray()) {
+					line << (first ? "" : is_roundtrip ? " > " : " - ") << stop.AsString();
+					first = false;
+				}
+			}
+			lines.push_back(line.str());
+		}
+		return lines;
+	}
+
+	/**
+	 * @brief Сравнивает разбор строк текстового формата: регулярные выражения против
+	 * разбора за один проход (text_input_parser.h).
+	 *
+	 * Строки строятся из base_requests и повторяются по кругу до text_lines штук.
+	 * Результаты обоих разборов сверяются на каждой исходной строке и на наборе
+	 * граничных случаев (в том числе некорректных строк).
+	 */
+	void CompareTextParsers(const json::Document& input, const Options& options, Report& report) {
+		std::vector<std::string> lines = MakeTextLines(input);
+		if (lines.empty()) {
+			return;
+		}
+
+		std::vector<std::string> checked = lines;
+		for (const char* line : {
+			"Stop A: 55.5, 37.2", "Stop A: +.5,-1", "Stop A:  1, 2", "Stop  A: 1, 2", "Stop A:1, 2",
+			"Stop A B: 1,\t2,  3m to B, 3m to B, 4m to C", "Stop A: 1, 2, 10m to B,5m to ,7m to C D",
+			"Stop A: 1., 2", "Stop A: 1, 2 ", "Stop A: 1, 2,", "Stop A: 1, 2, x12m to B", "Stop A: 1e5, 2",
+			"Stop A: 1, 2, 99999999999m to B", "Stop A\t: 1, 2", "Stop A: 1, 2, 1m to B\r", "Stop : 1, 2",
+			"Bus 7: A > B > A", "Bus 7 x: A - B", "Bus : A", "Bus 7:", "Bus 7: ", "Route 7: A", "" }) {
+			checked.emplace_back(line);
+		}
+		size_t mismatches = 0;
+		for (const auto& line : checked) {
+			const auto expected = ParseTextLine(line,
+				[](std::string_view text) { return regex_parser::ParseCommandDescription(text); },
+				[](std::string_view text) { return regex_parser::ParseStopData(text); });
+			const auto actual = ParseTextLine(line,
+				[](std::string_view text) { return ParseCommandDescription(text); },
+				[](std::string_view text) { return ParseStopData(text); });
+			mismatches += expected == actual ? 0 : 1;
+		}
+
+		auto run = [&](std::string phase, auto parse_command, auto parse_stop) {
+			size_t distances = 0;
+			report.Measure(std::move(phase), static_cast<double>(options.text_lines), "lines/s", [&] {
+				for (size_t i = 0; i < options.text_lines; ++i) {
+					const auto command = parse_command(lines[i % lines.size()]);
+					if (command.command == "Stop") {
+						distances += parse_stop(command.description).nearby_stops.size();
+					}
+				}
+			});
+			return distances;
+		};
+		const size_t regex_distances = run("text parse: regex",
+			[](std::string_view text) { return regex_parser::ParseCommandDescription(text); },
+			[](std::string_view text) { return regex_parser::ParseStopData(text); });
+		const size_t scan_distances = run("text parse: single pass",
+			[](std::string_view text) { return ParseCommandDescription(text); },
+			[](std::string_view text) { return ParseStopData(text); });
+
+		std::cout << "text parse: " << lines.size() << " distinct lines, " << checked.size()
+			<< " checked, mismatches " << mismatches << '\n';
+		if (mismatches > 0 || regex_distances != scan_distances) {
+			std::cout << "WARNING: text parsers disagree\n";
+		}
+	}
+
+	/// Ответ на запрос текстового формата через форматирование потока (std::fixed, setprecision) — эталон для stat_r
+	void PrintStatWithStream(const trans_cat::TransportCatalogue& catalogue, std::string_view request, std::ostream& out) {
+		const size_t pos = request.find(' ');
+		const std::string_view command = request.substr(0, pos);
+		const std::string_view name = request.substr(pos + 1);
+		if (command == "Bus") {
+			out << "Bus " << name;
+			if (const auto stat = catalogue.GetRouteStat(name)) {
+				out << ": " << stat->stop_count << " stops on route, " << stat->unique_stop_count << " unique stops, "
+					<< std::fixed << std::setprecision(0) << stat->route_length << " route length, "
+					<< std::setprecision(5) << stat->curvature << " curvature\n";
+			}
+			else {
+				out << ": not found\n";
+			}
+		}
+		else if (command == "Stop") {
+			out << "Stop " << name;
+			const auto* stop = catalogue.FindStop(name);
+			if (!stop) {
+				out << ": not found\n";
+			}
+			else if (catalogue.GetBusesByStop(stop).empty()) {
+				out << ": no buses\n";
+			}
+			else {
+				out << ": buses";
+				for (const auto* route : catalogue.GetBusesByStop(stop)) {
+					out << ' ' << route->name;
+				}
+				out << '\n';
+			}
+		}
+		else {
+			out << "Unknown command\n";
+		}
+	}
+
+	/**
+	 * @brief Сверяет текстовый конвейер (InputReader, stat_r) с JSON-каталогом.
+	 *
+	 * База переводится в текстовый формат (координаты с 15 знаками — без потери точности)
+	 * и загружается InputReader в отдельный каталог. Запросы Bus/Stop ко всем
+	 * маршрутам и остановкам (и к несуществующим) повторяются до stat_requests строк.
+	 * Вывод ParseAndPrintStat и StatWriter должен побайтно совпадать с эталоном,
+	 * отформатированным через поток (PrintStatWithStream), — и на JSON-каталоге,
+	 * и на каталоге из текстового формата.
+	 */
+	void CompareStatOutput(const trans_cat::TransportCatalogue& catalogue, const json::Document& input,
+		const Options& options, Report& report) {
+		const auto base_lines = MakeTextLines(input, 15);
+		std::string base_text = std::to_string(base_lines.size()) + '\n';
+		for (const auto& line : base_lines) {
+			base_text.append(line).push_back('\n');
+		}
+
+		trans_cat::TransportCatalogue text_catalogue;
+		report.Measure("text stat: InputReader load", static_cast<double>(base_lines.size()), "lines/s", [&] {
+			std::istringstream in(base_text);
+			InputReader().LoadCatalog(in, text_catalogue);
+		});
+
+		std::vector<std::string> names{ "Bus no such bus", "Stop no such stop" };
+		for (const auto* route : catalogue.GetRoutesInInsertionOrder()) {
+			names.push_back("Bus " + std::string(route->name));
+			for (const auto* stop : route->stops) {
+				names.push_back("Stop " + std::string(stop->name));
+			}
+		}
+		std::vector<std::string_view> requests;
+		requests.reserve(options.stat_requests);
+		for (size_t i = 0; i < options.stat_requests; ++i) {
+			requests.push_back(names[i % names.size()]);
+		}
+
+		std::ostringstream expected;
+		report.Measure("text stat: ostream formatting", static_cast<double>(requests.size()), "req/s", [&] {
+			for (std::string_view request : requests) {
+				PrintStatWithStream(catalogue, request, expected);
+			}
+		});
+		std::ostringstream printed;
+		report.Measure("text stat: ParseAndPrintStat", static_cast<double>(requests.size()), "req/s", [&] {
+			for (std::string_view request : requests) {
+				stat_r::ParseAndPrintStat(catalogue, request, printed);
+			}
+		});
+
+		auto write = [&](const trans_cat::TransportCatalogue& source) {
+			std::ostringstream out;
+			stat_r::StatWriter writer(out);
+			for (std::string_view request : requests) {
+				writer.ParseAndPrintStat(source, request);
+			}
+			writer.Flush();
+			return out.str();
+		};
+		std::string actual;
+		report.Measure("text stat: StatWriter", static_cast<double>(requests.size()), "req/s", [&] {
+			actual = write(catalogue);
+		});
+		const std::string text_actual = write(text_catalogue);
+
+		auto verdict = [&expected](const std::string& output) {
+			return output == expected.str() ? "identical" : "DIFFERS";
+		};
+		std::cout << "text stat: " << requests.size() << " requests, " << expected.str().size() << " bytes; "
+			<< "ParseAndPrintStat " << verdict(printed.str()) << ", StatWriter " << verdict(actual)
+			<< ", text-format catalogue " << verdict(text_actual) << '\n';
+		if (printed.str() != expected.str() || actual != expected.str() || text_actual != expected.str()) {
+			std::cout << "WARNING: text-format output differs from ParseAndPrintStat\n";
+		}
+	}
+
+	bench::RequestMix ParseMix(std::string_view text) {
+		std::vector<double> parts;
+		std::istringstream in{ std::string(text) };
+		for (std::string part; std::getline(in, part, ':');) {
+			parts.push_back(std::stod(part));
+		}
+		if (parts.size() != 4) {
+			throw std::invalid_argument("--mix expects BUS:STOP:ROUTE:MAP");
+		}
+		return bench::RequestMix{ parts[0], parts[1], parts[2], parts[3] };
+	}
+
+	Options ParseOptions(int argc, char** argv) {
+		Options options;
+		auto& city = options.city;
+
+		for (int i = 1; i < argc; ++i) {
+			const std::string_view arg = argv[i];
+			auto next = [&]() -> std::string_view {
+				if (i + 1 >= argc) {
+					throw std::invalid_argument(std::string(arg) + " expects a value");
+				}
+				return argv[++i];
+			};
+			auto next_size = [&]() { return static_cast<size_t>(std::stoull(std::string(next()))); };
+
+			if (arg == "--stops") city.stop_count = next_size();
+			else if (arg == "--routes") city.route_count = next_size();
+			else if (arg == "--min-length") city.min_route_length = next_size();
+			else if (arg == "--max-length") city.max_route_length = next_size();
+			else if (arg == "--roundtrip-share") city.roundtrip_share = std::stod(std::string(next()));
+			else if (arg == "--requests") city.request_count = next_size();
+			else if (arg == "--mix") city.mix = ParseMix(next());
+			else if (arg == "--seed") city.seed = next_size();
+			else if (arg == "--no-render") city.with_render_settings = false;
+			else if (arg == "--emit") options.emit = true;
+			else if (arg == "--route-queries") options.route_queries = next_size();
+			else if (arg == "--landmarks") options.landmark_count = next_size();
+			else if (arg == "--alternatives") options.alternatives = next_size();
+			else if (arg == "--lookups") options.lookups = next_size();
+			else if (arg == "--stop-searches") options.stop_searches = next_size();
+			else if (arg == "--distance-rounds") options.distance_rounds = next_size();
+			else if (arg == "--text-lines") options.text_lines = next_size();
+			else if (arg == "--stat-requests") options.stat_requests = next_size();
+			else if (arg == "--incremental-changes") options.incremental_changes = next_size();
+			else if (arg == "--incremental-strategy") {
+				const auto strategy = transport_router::ParseRoutingStrategy(next());
+				if (!strategy) {
+					throw std::invalid_argument("Unknown routing strategy");
+				}
+				options.incremental_strategy = *strategy;
+			}
+			else throw std::invalid_argument("Unknown option: " + std::string(arg));
+		}
+		return options;
+	}
+
+} // namespace
+
+int main(int argc, char** argv) {
+	try {
+		const Options options = ParseOptions(argc, argv);
+		const auto& city = options.city;
+
+		if (options.emit) {
+			json::Print(bench::CityGenerator(city).Generate(), std::cout);
+			return 0;
+		}
+
+		std::cerr << "City: " << city.stop_count << " stops, " << city.route_count << " routes ("
+			<< city.min_route_length << '-' << city.max_route_length << " stops each), "
+			<< city.request_count << " requests, seed " << city.seed << std::endl;
+
+		Report report;
+
+		json::Document generated;
+		report.Measure("generate", static_cast<double>(city.stop_count + city.route_count), "objects/s", [&] {
+			generated = bench::CityGenerator(city).Generate();
+		});
+
+		std::string text;
+		const double print_seconds = Report::Time([&] {
+			std::ostringstream out;
+			json::Print(generated, out);
+			text = out.str();
+		});
+		const double text_mb = static_cast<double>(text.size()) / (1024.0 * 1024.0);
+		report.Add("json::Print", print_seconds, text_mb, "MB/s");
+		generated = json::Document{};
+
+		json::Document input;
+		report.Measure("json::Load", text_mb, "MB/s", [&] {
+			std::istringstream in(text);
+			input = json::Load(in);
+		});
+
+		// Поштучная загрузка (AddStop/SetDistance/AddRoute) — для сравнения с пакетной
+		const double base_count = static_cast<double>(input.GetRoot().AsDict().at("base_requests").AsArray().size());
+		{
+			trans_cat::TransportCatalogue incremental;
+			report.Measure("load: incremental", base_count, "objects/s", [&] {
+				json_reader::JSONReader(incremental).LoadFromJsonIncremental(input);
+			});
+		}
+
+		trans_cat::TransportCatalogue catalogue;
+		const size_t heap_before_load = HeapInUseBytes();
+		report.Measure("load: bulk (LoadFromJson)", base_count, "objects/s", [&] {
+			json_reader::JSONReader(catalogue).LoadFromJson(input);
+		});
+		const size_t catalogue_heap = HeapInUseBytes() - heap_before_load;
+
+		// Как в main: после загрузки каталог только читается
+		catalogue.Freeze();
+
+		// Create строит маршрутизатор: граф и таблицу кратчайших путей.
+		// Обработчик не перемещаемый — создаём его сразу в куче
+		std::unique_ptr<request_handler::RequestHandler> handler;
+		report.Measure("RequestHandler::Create", static_cast<double>(catalogue.GetAllStops().size()), "stops/s", [&] {
+			handler.reset(new request_handler::RequestHandler(
+				request_handler::RequestHandler::Create(catalogue, input)));
+		});
+
+		// Запросы группируем по типу, чтобы замерить каждый тип отдельно
+		std::map<std::string, json::Array> requests_by_type;
+		for (const auto& request : json_reader::JSONReader::GetStatRequests(input)) {
+			requests_by_type[request.AsDict().at("type").AsString()].push_back(request);
+		}
+		for (const auto& [type, requests] : requests_by_type) {
+			report.Measure("requests: " + type, static_cast<double>(requests.size()), "req/s", [&] {
+				handler->ProcessRequests(requests);
+			});
+		}
+
+		if (options.route_queries > 0) {
+			CompareRouteSearches(catalogue, input, options, report);
+		}
+		if (options.lookups > 0) {
+			CompareNameLookups(catalogue, options, report);
+		}
+		if (options.stop_searches > 0) {
+			MeasureStopSearch(catalogue, options, report);
+		}
+		if (options.distance_rounds > 0) {
+			MeasureDistances(catalogue, input, options, report);
+			CheckPathLength(catalogue, options, report);
+		}
+		if (options.text_lines > 0) {
+			CompareTextParsers(input, options, report);
+		}
+		if (options.stat_requests > 0) {
+			CompareStatOutput(catalogue, input, options, report);
+		}
+		if (options.incremental_changes > 0) {
+			CheckIncrementalUpdates(input, options, report);
+		}
+
+		std::cout << "input size: " << std::fixed << std::setprecision(2) << text_mb << " MB\n";
+		report.Print(std::cout);
+
+		constexpr double MB = 1024.0 * 1024.0;
+		const trans_cat::StringArena& names = catalogue.GetNameArena();
+		std::cout << "catalogue heap: ";
+		if (heap_before_load > 0) {
+			std::cout << static_cast<double>(catalogue_heap) / MB << " MB\n";
+		}
+		else {
+			std::cout << "n/a\n";
+		}
+		std::cout << "names: " << names.GetStringCount() << " strings, "
+			<< static_cast<double>(names.GetStoredBytes()) / MB << " MB stored, "
+			<< static_cast<double>(names.GetReservedBytes()) / MB << " MB reserved\n";
+		return 0;
+	}
+	catch (const std::exception& e) {
+		std::cerr << "Error: " << e.what() << std::endl;
+		return 1;
+	}
+}
@@ -0,0 +1,227 @@
+#include "city_generator.h"
+#include "../Transport_Directory/geo.h"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace bench {
+
+	using namespace std::string_literals;
+
+	namespace {
+
+		// Границы города: ~20 км по широте и долготе
+		constexpr double MIN_LAT = 55.60;
+		constexpr double MIN_LNG = 37.40;
+		constexpr double LAT_SPAN = 0.18;
+		constexpr double LNG_SPAN = 0.30;
+
+		std::string StopName(size_t index) {
+			return "Stop "s + std::to_string(index);
+		}
+
+		std::string BusName(size_t index) {
+			return "Bus "s + std::to_string(index);
+		}
+
+	} // namespace
+
+	CityGenerator::CityGenerator(CityConfig config)
+		: config_(std::move(config))
+		, engine_(config_.seed)
+	{
+		config_.stop_count = std::max<size_t>(2, config_.stop_count);
+		config_.min_route_length = std::max<size_t>(2, config_.min_route_length);
+		config_.max_route_length = std::max(config_.min_route_length, config_.max_route_length);
+	}
+
+	size_t CityGenerator::NextIndex(size_t bound) {
+		return static_cast<size_t>(engine_() % bound);
+	}
+
+	double CityGenerator::NextUnit() {
+		// 53 старших бита → равномерное число в [0, 1)
+		return static_cast<double>(engine_() >> 11) * 0x1.0p-53;
+	}
+
+	json::Document CityGenerator::Generate() {
+		json::Dict root;
+		root.emplace("base_requests", GenerateBaseRequests());
+		root.emplace("routing_settings", json::Dict{
+			{ "bus_wait_time"s, json::Node(2 + static_cast<int>(NextIndex(8))) },
+			{ "bus_velocity"s, json::Node(20.0 + static_cast<double>(NextIndex(40))) } });
+		if (config_.with_render_settings) {
+			root.emplace("render_settings", GenerateRenderSettings());
+		}
+		root.emplace("stat_requests", GenerateStatRequests());
+		return json::Document(json::Node(std::move(root)));
+	}
+
+	/**
+	 * Остановки раскладываются по сетке с небольшим случайным сдвигом:
+	 * соседи по сетке — это соседи на карте, поэтому маршрут строится
+	 * как случайная прогулка по соседним клеткам за O(1) на шаг.
+	 */
+	json::Array CityGenerator::GenerateBaseRequests() {
+		const size_t stop_count = config_.stop_count;
+		const size_t grid_width = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(stop_count))));
+		const size_t grid_height = (stop_count + grid_width - 1) / grid_width;
+
+		std::vector<geo::Coordinates> coordinates(stop_count);
+		for (size_t i = 0; i < stop_count; ++i) {
+			const double row = static_cast<double>(i / grid_width) + NextUnit() * 0.8;
+			const double col = static_cast<double>(i % grid_width) + NextUnit() * 0.8;
+			coordinates[i] = {
+				MIN_LAT + LAT_SPAN * row / static_cast<double>(grid_height),
+				MIN_LNG + LNG_SPAN * col / static_cast<double>(grid_width)
+			};
+		}
+
+		// Случайный сосед по сетке (4-связность), не выходящий за границы
+		auto random_neighbour = [&](size_t index) {
+			const size_t row = index / grid_width;
+			const size_t col = index % grid_width;
+			for (;;) {
+				size_t candidate = index;
+				switch (NextIndex(4)) {
+				case 0: if (row > 0) candidate = index - grid_width; break;
+				case 1: if (row + 1 < grid_height) candidate = index + grid_width; break;
+				case 2: if (col > 0) candidate = index - 1; break;
+				default: if (col + 1 < grid_width) candidate = index + 1; break;
+				}
+				if (candidate != index && candidate < stop_count) {
+					return candidate;
+				}
+			}
+		};
+
+		// Маршруты и дорожные расстояния между соседними остановками маршрутов
+		std::vector<std::map<size_t, int>> road_distances(stop_count);
+		auto set_distance = [&](size_t from, size_t to) {
+			if (road_distances[from].count(to)) {
+				return;
+			}
+			const double direct = geo::ComputeDistance(coordinates[from], coordinates[to]);
+			road_distances[from][to] = static_cast<int>(std::lround(direct * (1.1 + 0.5 * NextUnit()))) + 1;
+		};
+
+		json::Array buses;
+		buses.reserve(config_.route_count);
+		for (size_t r = 0; r < config_.route_count; ++r) {
+			const size_t length = config_.min_route_length
+				+ NextIndex(config_.max_route_length - config_.min_route_length + 1);
+			const bool is_roundtrip = NextUnit() < config_.roundtrip_share;
+
+			std::vector<size_t> stops{ NextIndex(stop_count) };
+			while (stops.size() < length) {
+				stops.push_back(random_neighbour(stops.back()));
+			}
+			if (is_roundtrip) {
+				stops.push_back(stops.front());
+			}
+
+			json::Array stop_names;
+			stop_names.reserve(stops.size());
+			for (size_t i = 0; i < stops.size(); ++i) {
+				stop_names.push_back(json::Node(StopName(stops[i])));
+				if (i > 0) {
+					set_distance(stops[i - 1], stops[i]);
+					// Обратное расстояние задаём не всегда — проверяем fallback на симметрию
+					if (!is_roundtrip && NextUnit() < 0.5) {
+						set_distance(stops[i], stops[i - 1]);
+					}
+				}
+			}
+
+			buses.push_back(json::Dict{
+				{ "type"s, json::Node("Bus"s) },
+				{ "name"s, json::Node(BusName(r)) },
+				{ "stops"s, json::Node(std::move(stop_names)) },
+				{ "is_roundtrip"s, json::Node(is_roundtrip) } });
+		}
+
+		json::Array result;
+		result.reserve(stop_count + buses.size());
+		for (size_t i = 0; i < stop_count; ++i) {
+			json::Dict distances;
+			for (const auto& [to, meters] : road_distances[i]) {
+				distances.emplace(StopName(to), json::Node(meters));
+			}
+
+			result.push_back(json::Dict{
+				{ "type"s, json::Node("Stop"s) },
+				{ "name"s, json::Node(StopName(i)) },
+				{ "latitude"s, json::Node(coordinates[i].lat) },
+				{ "longitude"s, json::Node(coordinates[i].lng) },
+				{ "road_distances"s, json::Node(std::move(distances)) } });
+		}
+		for (auto& bus : buses) {
+			result.push_back(std::move(bus));
+		}
+
+		return result;
+	}
+
+	json::Array CityGenerator::GenerateStatRequests() {
+		const RequestMix& mix = config_.mix;
+		const double total = mix.bus + mix.stop + mix.route + mix.map;
+
+		// Имя существующего объекта или (с заданной вероятностью) несуществующего
+		auto pick_name = [this](size_t count, std::string (*make_name)(size_t)) {
+			if (count == 0 || NextUnit() < config_.unknown_name_share) {
+				return "Unknown "s + std::to_string(NextIndex(1000));
+			}
+			return make_name(NextIndex(count));
+		};
+
+		json::Array requests;
+		requests.reserve(config_.request_count);
+		for (size_t id = 0; id < config_.request_count; ++id) {
+			const double kind = NextUnit() * total;
+			json::Dict request{ { "id"s, json::Node(static_cast<int>(id)) } };
+
+			if (kind < mix.bus) {
+				request.emplace("type", json::Node("Bus"s));
+				request.emplace("name", json::Node(pick_name(config_.route_count, BusName)));
+			}
+			else if (kind < mix.bus + mix.stop) {
+				request.emplace("type", json::Node("Stop"s));
+				request.emplace("name", json::Node(pick_name(config_.stop_count, StopName)));
+			}
+			else if (kind < mix.bus + mix.stop + mix.route) {
+				request.emplace("type", json::Node("Route"s));
+				request.emplace("from", json::Node(pick_name(config_.stop_count, StopName)));
+				request.emplace("to", json::Node(pick_name(config_.stop_count, StopName)));
+			}
+			else {
+				request.emplace("type", json::Node("Map"s));
+			}
+			requests.push_back(std::move(request));
+		}
+
+		return requests;
+	}
+
+	json::Dict CityGenerator::GenerateRenderSettings() {
+		return json::Dict{
+			{ "width"s, json::Node(1200.0) },
+			{ "height"s, json::Node(1200.0) },
+			{ "padding"s, json::Node(50.0) },
+			{ "stop_radius"s, json::Node(5.0) },
+			{ "line_width"s, json::Node(14.0) },
+			{ "bus_label_font_size"s, json::Node(20) },
+			{ "bus_label_offset"s, json::Node(json::Array{ json::Node(7.0), json::Node(15.0) }) },
+			{ "stop_label_font_size"s, json::Node(20) },
+			{ "stop_label_offset"s, json::Node(json::Array{ json::Node(7.0), json::Node(-3.0) }) },
+			{ "underlayer_color"s, json::Node(json::Array{
+				json::Node(255), json::Node(255), json::Node(255), json::Node(0.85) }) },
+			{ "underlayer_width"s, json::Node(3.0) },
+			{ "color_palette"s, json::Node(json::Array{
+				json::Node("green"s), json::Node(json::Array{ json::Node(255), json::Node(160), json::Node(0) }),
+				json::Node("red"s) }) } };
+	}
+
+} // namespace bench
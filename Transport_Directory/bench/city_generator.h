@@ -0,0 +1,72 @@
+#pragma once
+
+#include "../Transport_Directory/json.h"
+
+#include <cstdint>
+#include <random>
+
+/**
+ * @brief Генератор синтетических транспортных сетей для нагрузочных тестов.
+ *
+ * Строит входной документ в формате Transport_Directory (base_requests,
+ * routing_settings, render_settings, stat_requests) заданного размера.
+ * Результат полностью определяется конфигурацией и seed: один и тот же
+ * набор параметров на любой платформе даёт один и тот же документ.
+ */
+namespace bench {
+
+	/// Доли запросов разных типов в stat_requests (нормируются к сумме)
+	struct RequestMix {
+		double bus = 0.3;
+		double stop = 0.3;
+		double route = 0.39;
+		double map = 0.01;
+	};
+
+	/// Параметры синтетического города
+	struct CityConfig {
+		size_t stop_count = 1000;           ///< Число остановок
+		size_t route_count = 100;           ///< Число маршрутов
+		size_t min_route_length = 5;        ///< Минимум остановок в маршруте
+		size_t max_route_length = 30;       ///< Максимум остановок в маршруте
+		double roundtrip_share = 0.3;       ///< Доля кольцевых маршрутов
+		size_t request_count = 10000;       ///< Число stat_requests
+		RequestMix mix;                     ///< Состав запросов
+		double unknown_name_share = 0.02;   ///< Доля запросов к несуществующим объектам
+		bool with_render_settings = true;   ///< Добавлять ли render_settings
+		uint64_t seed = 42;                 ///< Зерно генератора
+	};
+
+	/**
+	 * @brief Генератор синтетического города.
+	 *
+	 * Остановки раскладываются случайно в квадрате ~20×20 км, маршруты строятся
+	 * как "прогулки" по ближайшим соседям, дорожные расстояния — это расстояние
+	 * по прямой, умноженное на коэффициент извилистости 1.1–1.6.
+	 */
+	class CityGenerator {
+	public:
+		explicit CityGenerator(CityConfig config);
+
+		/// Строит полный входной документ
+		json::Document Generate();
+
+	private:
+		// Равномерно распределённое целое в [0, bound)
+		size_t NextIndex(size_t bound);
+
+		// Равномерно распределённое вещественное в [0, 1)
+		double NextUnit();
+
+		json::Array GenerateBaseRequests();
+		json::Array GenerateStatRequests();
+		static json::Dict GenerateRenderSettings();
+
+		CityConfig config_;
+
+		// std::mt19937_64 стандартизирован, в отличие от std::*_distribution, —
+		// распределения реализуем сами, чтобы вывод не зависел от платформы
+		std::mt19937_64 engine_;
+	};
+
+} // namespace bench
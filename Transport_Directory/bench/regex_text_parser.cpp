@@ -0,0 +1,100 @@
+#include "regex_text_parser.h"
+
+#include <regex>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace regex_parser {
+
+	namespace {
+
+		/*
+		 * Regex для парсинга команд
+		 *
+		 * Для команды Stop:
+		 * ^ Stop([^ \s:] + (? : [^ \s:] *)*) : (.*)$
+		 *		[^ \s:] + (? : [^ \s:] *) * — id может содержать пробелы, но не включает ':'
+		 *		(.*) — всё остальное — description (координаты и расстояния до соседних остановок)
+		 *
+		 * Для команды Bus:
+		 * ^ Bus([^ \s:] + ) : (.*)$
+		 *		[^ \s:] + (? : [^ \s:] *) * — id может содержать пробелы, но не включает ':'
+		 *		(.*) — всё остальное — description (маршрут)
+		 */
+		const std::vector<std::pair<std::regex, std::string>> cmd_regs{
+			std::pair(std::regex(R"(^Stop ([^\s:]+(?: [^\s:]*)*): (.*)$)"), "Stop"),
+			std::pair(std::regex(R"(^Bus ([^\s:]+(?: [^\s:]*)*): (.*)$)"), "Bus") };
+
+		/*
+		 * Regex для координат. Извлекает широту, долготу и опциональную оставшуюся часть строки
+		 *	([-+] ? \d * \. ? \d + ) — широта(с поддержкой знака, десятичной точки).
+		 *	, \s* — запятая с возможными пробелами.
+		 *	([-+] ? \d * \. ? \d + ) — долгота.
+		 *	(? : , \s* (.*)) ? — опциональная часть после запятой(расстояния до соседних остановок).
+		 */
+		const std::regex coords_regex{ R"(([-+]?\d*\.?\d+),\s*([-+]?\d*\.?\d+)(?:,\s*(.*))?)" };
+
+		// Regex для расстояний. Извлекает расстояние и имя остановки
+		const std::regex distance_regex{ R"((\d+)m to ([^,]+))" };
+
+	} // namespace
+
+	CommandDescription ParseCommandDescription(std::string_view line) {
+		CommandDescription result{};
+		std::smatch match;
+
+		// Преобразуем string_view в string
+		std::string line_str(line);
+
+		for (const auto& cmd_reg : cmd_regs) {
+			if (std::regex_match(line_str, match, cmd_reg.first)) {
+				result.command = cmd_reg.second;
+				result.id = match[1].str();
+				result.description = match[2].str();
+				break;
+			}
+		}
+
+		return result;
+	}
+
+	StopData ParseStopData(std::string_view str_view) {
+		const std::string str(str_view);
+		StopData stop_data;
+		std::smatch coords_match;
+
+		// Выделение географических координат
+		if (!std::regex_match(str, coords_match, coords_regex)) {
+			throw std::invalid_argument("Invalid stop data format");
+		}
+
+		// Попытка получения географических координат
+		try {
+			stop_data.coordinates.lat = std::stod(std::string(coords_match[1].str()));
+			stop_data.coordinates.lng = std::stod(std::string(coords_match[2].str()));
+		}
+		catch (...) {
+			throw std::invalid_argument("Invalid coordinates in stop data");
+		}
+
+		// Остаток строки - набор расстояний и наименований соседних остановок
+		std::string remaining_string(coords_match[3].str());
+
+		// Итераторы - бегунок и конец строки
+		std::sregex_iterator it(remaining_string.begin(), remaining_string.end(), distance_regex);
+		std::sregex_iterator end;
+
+		// Парсинг соседних остановок
+		for (; it != end; ++it) {
+			std::smatch match = *it;
+			int distance = std::stoi(match[1].str());
+			std::string name(match[2].str());
+			stop_data.nearby_stops.emplace(std::move(name), distance);
+		}
+
+		return stop_data;
+	}
+
+} // namespace regex_parser
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "../Transport_Directory/text_input_parser.h"
+
+#include <string_view>
+
+/*
+ * Прежний разбор текстового формата базы регулярными выражениями.
+ * В справочнике его заменили ParseCommandDescription/ParseStopData
+ * (Transport_Directory/text_input_parser.h); здесь он остаётся эталоном
+ * для сравнения и замеров (benchmark.cpp, --text-lines).
+ */
+namespace regex_parser {
+
+	CommandDescription ParseCommandDescription(std::string_view line);
+
+	StopData ParseStopData(std::string_view str);
+
+} // namespace regex_parser
@@ -0,0 +1,310 @@
+// Нагрузочный клиент для transport_server.
+//
+// Открывает несколько keep-alive соединений, в каждом последовательно отправляет
+// POST /api/query с запросами из stat_requests входного документа и замеряет
+// задержку каждого ответа. Выводит пропускную способность (QPS) и перцентили задержки.
+//
+// Проверка утечек на долгом прогоне: нагрузка повторяется --rounds раз, после каждого
+// прогона резидентная память сервера читается из GET /api/diagnostics (process.rss_mb).
+// Первый прогон прогревает кэши; рост памяти от его конца до конца последнего прогона
+// не должен превышать --max-rss-growth МБ, иначе код возврата 1. С --reconnect каждый
+// запрос идёт по новому соединению — так проверяются ресурсы, выделяемые на соединение.
+//
+// Сборка (из каталога Transport_Directory):
+//   g++ -std=c++20 -O2 -pthread -o load_generator server/load_generator.cpp
+//       Transport_Directory/json.cpp
+//
+// Запуск (запросы удобно взять из сгенерированного города, см. bench/benchmark.cpp --emit):
+//   ./transport_server city.json --port 8080 &
+//   ./load_generator --input city.json --port 8080 --connections 8 --requests 20000
+//
+// Параметры:
+//   --input FILE (обязателен), --host H, --port N, --connections N, --requests N,
+//   --batch N (stat_requests в одном HTTP-запросе), --warmup N (на соединение, без замера),
+//   --reconnect (новое соединение на каждый запрос), --rounds N (повторов нагрузки, по умолчанию 1),
+//   --max-rss-growth MB (допустимый рост памяти сервера после первого прогона, по умолчанию 8)
+//
+// Пример проверки утечек:
+//   ./load_generator --input city.json --connections 4 --requests 3000 --reconnect --rounds 4
+
+// Boost.Beast будет использовать std::string_view вместо boost::string_view
+#define BOOST_BEAST_USE_STD_STRING_VIEW
+
+#include "../Transport_Directory/json.h"
+
+#include <boost/asio.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace beast = boost::beast;
+namespace http = beast::http;
+namespace net = boost::asio;
+using tcp = net::ip::tcp;
+
+namespace {
+
+	using Clock = std::chrono::steady_clock;
+
+	struct Options {
+		std::string input_path;
+		std::string host = "127.0.0.1";
+		std::string port = "8080";
+		size_t connections = 4;
+		size_t requests = 10000;
+		size_t batch = 1;
+		size_t warmup = 10;
+		bool reconnect = false;
+		size_t rounds = 1;
+		double max_rss_growth_mb = 8.0;
+	};
+
+	/// Результаты одного соединения
+	struct WorkerResult {
+		std::vector<double> latencies_ms;
+		size_t errors = 0;
+		std::string failure;  ///< Непустое, если соединение оборвалось
+	};
+
+	Options ParseOptions(int argc, char** argv) {
+		Options options;
+		for (int i = 1; i < argc; ++i) {
+			const std::string_view arg = argv[i];
+			auto next = [&]() -> std::string {
+				if (i + 1 >= argc) {
+					throw std::invalid_argument(std::string(arg) + " expects a value");
+				}
+				return argv[++i];
+			};
+			auto next_size = [&]() { return static_cast<size_t>(std::stoull(next())); };
+
+			if (arg == "--input") options.input_path = next();
+			else if (arg == "--host") options.host = next();
+			else if (arg == "--port") options.port = next();
+			else if (arg == "--connections") options.connections = std::max<size_t>(1, next_size());
+			else if (arg == "--requests") options.requests = next_size();
+			else if (arg == "--batch") options.batch = std::max<size_t>(1, next_size());
+			else if (arg == "--warmup") options.warmup = next_size();
+			else if (arg == "--reconnect") options.reconnect = true;
+			else if (arg == "--rounds") options.rounds = std::max<size_t>(1, next_size());
+			else if (arg == "--max-rss-growth") options.max_rss_growth_mb = std::stod(next());
+			else throw std::invalid_argument("Unknown option: " + std::string(arg));
+		}
+		if (options.input_path.empty()) {
+			throw std::invalid_argument("--input is required");
+		}
+		return options;
+	}
+
+	// Тела HTTP-запросов: stat_requests документа, нарезанные по batch штук
+	std::vector<std::string> MakeBodies(const std::string& path, size_t batch) {
+		std::ifstream in(path);
+		if (!in) {
+			throw std::runtime_error("Cannot open " + path);
+		}
+		const json::Document document = json::Load(in);
+		const auto& root = document.GetRoot().AsDict();
+		auto it = root.find("stat_requests");
+		if (it == root.end() || it->second.AsArray().empty()) {
+			throw std::runtime_error("No stat_requests in " + path);
+		}
+
+		const json::Array& requests = it->second.AsArray();
+		std::vector<std::string> bodies;
+		for (size_t begin = 0; begin < requests.size(); begin += batch) {
+			const size_t end = std::min(requests.size(), begin + batch);
+			std::ostringstream out;
+			json::Print(json::Document(json::Node(json::Array(requests.begin() + begin, requests.begin() + end))), out);
+			bodies.push_back(std::move(out).str());
+		}
+		return bodies;
+	}
+
+	double Percentile(const std::vector<double>& sorted, double share) {
+		if (sorted.empty()) {
+			return 0.0;
+		}
+		const size_t index = std::min(sorted.size() - 1, static_cast<size_t>(share * static_cast<double>(sorted.size())));
+		return sorted[index];
+	}
+
+	/**
+	 * @brief Отправляет count запросов по одному соединению.
+	 *
+	 * Тела берутся по кругу, начиная со сдвига offset, чтобы соединения
+	 * не запрашивали одно и то же одновременно.
+	 */
+	WorkerResult RunWorker(const Options& options, const tcp::resolver::results_type& endpoints,
+		const std::vector<std::string>& bodies, size_t offset, size_t count) {
+		WorkerResult result;
+		result.latencies_ms.reserve(count);
+
+		try {
+			net::io_context ioc;
+			tcp::socket socket(ioc);
+			beast::flat_buffer buffer;
+
+			auto send = [&](size_t index) {
+				if (!socket.is_open()) {
+					net::connect(socket, endpoints);
+				}
+				http::request<http::string_body> request(http::verb::post, "/api/query", 11);
+				request.set(http::field::host, options.host);
+				request.set(http::field::content_type, "application/json");
+				request.keep_alive(!options.reconnect);
+				request.body() = bodies[index % bodies.size()];
+				request.prepare_payload();
+
+				http::write(socket, request);
+				http::response<http::string_body> response;
+				http::read(socket, buffer, response);
+				if (options.reconnect) {
+					beast::error_code ec;
+					socket.shutdown(tcp::socket::shutdown_both, ec);
+					socket.close(ec);
+					buffer.clear();
+				}
+				return response.result() == http::status::ok;
+			};
+
+			for (size_t i = 0; i < options.warmup; ++i) {
+				send(offset + i);
+			}
+			for (size_t i = 0; i < count; ++i) {
+				const auto start = Clock::now();
+				const bool ok = send(offset + options.warmup + i);
+				result.latencies_ms.push_back(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+				result.errors += !ok;
+			}
+
+			beast::error_code ec;
+			socket.shutdown(tcp::socket::shutdown_both, ec);
+		}
+		catch (const std::exception& e) {
+			result.failure = e.what();
+		}
+		return result;
+	}
+
+	/// Резидентная память сервера, МБ (process.rss_mb из GET /api/diagnostics)
+	double FetchServerRssMb(const Options& options, const tcp::resolver::results_type& endpoints) {
+		net::io_context ioc;
+		tcp::socket socket(ioc);
+		net::connect(socket, endpoints);
+
+		http::request<http::empty_body> request(http::verb::get, "/api/diagnostics", 11);
+		request.set(http::field::host, options.host);
+		request.keep_alive(false);
+		http::write(socket, request);
+
+		beast::flat_buffer buffer;
+		http::response<http::string_body> response;
+		http::read(socket, buffer, response);
+		beast::error_code ec;
+		socket.shutdown(tcp::socket::shutdown_both, ec);
+
+		std::istringstream body(response.body());
+		const json::Document document = json::Load(body);
+		return document.GetRoot().AsDict().at("process").AsDict().at("rss_mb").AsDouble();
+	}
+
+	/// Итоги одного прогона нагрузки
+	struct RoundResult {
+		std::vector<double> latencies_ms;   ///< Отсортированы
+		size_t errors = 0;
+		double seconds = 0.0;
+	};
+
+	RoundResult RunRound(const Options& options, const tcp::resolver::results_type& endpoints,
+		const std::vector<std::string>& bodies) {
+		// Запросы делим между соединениями поровну, остаток — первым
+		std::vector<WorkerResult> results(options.connections);
+		std::vector<std::thread> workers;
+		const auto start = Clock::now();
+		for (size_t i = 0; i < options.connections; ++i) {
+			const size_t count = options.requests / options.connections + (i < options.requests % options.connections);
+			const size_t offset = i * bodies.size() / options.connections;
+			workers.emplace_back([&, i, count, offset] {
+				results[i] = RunWorker(options, endpoints, bodies, offset, count);
+			});
+		}
+		for (auto& worker : workers) {
+			worker.join();
+		}
+
+		RoundResult round;
+		round.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+		for (const WorkerResult& result : results) {
+			round.latencies_ms.insert(round.latencies_ms.end(), result.latencies_ms.begin(), result.latencies_ms.end());
+			round.errors += result.errors;
+			if (!result.failure.empty()) {
+				std::cerr << "Connection failed: " << result.failure << std::endl;
+			}
+		}
+		std::sort(round.latencies_ms.begin(), round.latencies_ms.end());
+		return round;
+	}
+
+} // namespace
+
+int main(int argc, char** argv) {
+	try {
+		const Options options = ParseOptions(argc, argv);
+		const std::vector<std::string> bodies = MakeBodies(options.input_path, options.batch);
+
+		net::io_context ioc;
+		const auto endpoints = tcp::resolver(ioc).resolve(options.host, options.port);
+
+		bool ok = true;
+		std::vector<double> rss_mb;
+		for (size_t round_index = 0; round_index < options.rounds; ++round_index) {
+			const RoundResult round = RunRound(options, endpoints, bodies);
+			const auto& latencies = round.latencies_ms;
+			ok = ok && round.errors == 0 && latencies.size() == options.requests;
+
+			// Время включает прогрев — QPS занижен не больше чем на warmup·connections запросов
+			std::cout << std::fixed << std::setprecision(3);
+			if (options.rounds > 1) {
+				std::cout << "round " << round_index + 1 << '/' << options.rounds << '\n';
+			}
+			std::cout << "connections: " << options.connections << ", batch: " << options.batch
+				<< (options.reconnect ? ", new connection per request" : "") << '\n'
+				<< "requests:    " << latencies.size() << " (errors: " << round.errors << ")\n"
+				<< "elapsed:     " << round.seconds << " s\n"
+				<< "QPS:         " << static_cast<double>(latencies.size()) / round.seconds << '\n'
+				<< "latency, ms: p50 " << Percentile(latencies, 0.50)
+				<< ", p90 " << Percentile(latencies, 0.90)
+				<< ", p99 " << Percentile(latencies, 0.99)
+				<< ", max " << (latencies.empty() ? 0.0 : latencies.back()) << '\n';
+
+			if (options.rounds > 1) {
+				rss_mb.push_back(FetchServerRssMb(options, endpoints));
+				std::cout << "server RSS:  " << std::setprecision(1) << rss_mb.back() << " MB\n";
+			}
+		}
+
+		if (rss_mb.size() > 1) {
+			const double growth = rss_mb.back() - rss_mb.front();
+			const bool flat = growth <= options.max_rss_growth_mb;
+			std::cout << "RSS growth after round 1: " << std::setprecision(1) << growth << " MB (limit "
+				<< options.max_rss_growth_mb << " MB) — " << (flat ? "ok" : "LEAK SUSPECTED") << '\n';
+			ok = ok && flat;
+		}
+		return ok ? 0 : 1;
+	}
+	catch (const std::exception& e) {
+		std::cerr << "Error: " << e.what() << std::endl;
+		return 1;
+	}
+}
@@ -0,0 +1,306 @@
+// HTTP-сервер транспортного справочника.
+//
+// Загружает входной документ (base_requests, routing_settings, render_settings)
+// один раз, строит каталог и маршрутизатор и отвечает на запросы Bus/Stop/Route/Map
+// и другие stat_requests по HTTP/1.1 с keep-alive (см. query_service.h).
+//
+// Соединения обслуживаются асинхронно фиксированным пулом из --threads потоков
+// (число потоков не растёт с числом соединений); одновременно открыто не больше
+// --max-connections соединений, сверх лимита новое получает 503 и закрывается.
+// Соединение, простаивающее дольше IDLE_TIMEOUT, закрывается.
+//
+// Сборка (из каталога Transport_Directory; Boost.Beast — заголовочная библиотека,
+// подключается так же, как в sprint 17/WebServer — через conan или системный Boost):
+//   g++ -std=c++20 -O2 -pthread -o transport_server server/main.cpp server/query_service.cpp
+//       $(ls Transport_Directory/*.cpp | grep -v -e main.cpp -e input_reader -e stat_reader) -ltbb
+//   (без TBB — -DTRANSPORT_NO_PARALLEL вместо -ltbb, см. Transport_Directory/parallel.h)
+//
+// Запуск:
+//   ./transport_server city.json --port 8080
+//   curl -d '[{"id": 1, "type": "Bus", "name": "14"}]' http://127.0.0.1:8080/api/query
+//
+// Параметры:
+//   --address A (по умолчанию 127.0.0.1; 0.0.0.0 — все интерфейсы), --port N (по умолчанию 8080),
+//   --threads N (по умолчанию — число ядер), --max-connections N (по умолчанию 256),
+//   --enable-reload (разрешить POST /api/reload; без флага он отвечает 403)
+
+// Boost.Beast будет использовать std::string_view вместо boost::string_view
+#define BOOST_BEAST_USE_STD_STRING_VIEW
+
+#include "query_service.h"
+
+#include <boost/asio.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace beast = boost::beast;
+namespace http = beast::http;
+namespace net = boost::asio;
+
+// Запрос, тело которого представлено в виде строки
+using StringRequest = http::request<http::string_body>;
+// Ответ, тело которого представлено в виде строки
+using StringResponse = http::response<http::string_body>;
+using tcp = net::ip::tcp;
+using namespace std::literals;
+
+namespace {
+
+	/// Максимальный размер тела запроса к /api/query (пакет stat_requests) и прочим путям
+	constexpr uint64_t MAX_BODY_SIZE = 16ull * 1024 * 1024;
+
+	/// Максимальный размер тела /api/reload (полный входной документ; только с --enable-reload)
+	constexpr uint64_t MAX_RELOAD_BODY_SIZE = 256ull * 1024 * 1024;
+
+	/// Сколько соединение может простаивать (и сколько может длиться чтение одного запроса)
+	constexpr auto IDLE_TIMEOUT = 30s;
+
+	struct Options {
+		std::string input_path;
+		std::string address = "127.0.0.1";
+		unsigned short port = 8080;
+		size_t threads = std::max(1u, std::thread::hardware_concurrency());
+		size_t max_connections = 256;
+		bool enable_reload = false;
+	};
+
+	Options ParseOptions(int argc, char** argv) {
+		Options options;
+		for (int i = 1; i < argc; ++i) {
+			const std::string_view arg = argv[i];
+			auto next = [&]() -> std::string {
+				if (i + 1 >= argc) {
+					throw std::invalid_argument(std::string(arg) + " expects a value");
+				}
+				return argv[++i];
+			};
+			auto next_size = [&]() { return std::max<size_t>(1, std::stoul(next())); };
+
+			if (arg == "--address") options.address = next();
+			else if (arg == "--port") options.port = static_cast<unsigned short>(std::stoul(next()));
+			else if (arg == "--threads") options.threads = next_size();
+			else if (arg == "--max-connections") options.max_connections = next_size();
+			else if (arg == "--enable-reload") options.enable_reload = true;
+			else if (options.input_path.empty() && !arg.starts_with("--")) options.input_path = arg;
+			else throw std::invalid_argument("Unknown option: " + std::string(arg));
+		}
+		if (options.input_path.empty()) {
+			throw std::invalid_argument("Usage: transport_server <input.json> [--address A] [--port N]"
+				" [--threads N] [--max-connections N] [--enable-reload]");
+		}
+		return options;
+	}
+
+	StringResponse HandleRequest(server::QueryService& service, StringRequest&& req) {
+		server::HttpResult result = service.Handle(req.method_string(), req.target(), req.body());
+
+		StringResponse response(static_cast<http::status>(result.status), req.version());
+		response.set(http::field::content_type, result.content_type);
+		if (!result.allow.empty()) {
+			response.set(http::field::allow, result.allow);
+		}
+		response.body() = std::move(result.body);
+		response.content_length(response.body().size());
+		response.keep_alive(req.keep_alive());
+		return response;
+	}
+
+	/**
+	 * @brief Одно соединение: читает запросы и отвечает на них, пока клиент держит keep-alive.
+	 *
+	 * Операции соединения выполняются последовательно в его strand; объект живёт,
+	 * пока на него ссылается незавершённая операция. Счётчик открытых соединений
+	 * уменьшается в деструкторе.
+	 */
+	class Session : public std::enable_shared_from_this<Session> {
+	public:
+		Session(tcp::socket&& socket, server::QueryService& service, bool enable_reload,
+			std::atomic<size_t>& connections)
+			: stream_(std::move(socket))
+			, service_(service)
+			, enable_reload_(enable_reload)
+			, connections_(connections) {
+		}
+
+		Session(const Session&) = delete;
+		Session& operator=(const Session&) = delete;
+
+		~Session() {
+			connections_.fetch_sub(1, std::memory_order_relaxed);
+		}
+
+		void Run() {
+			// Начинаем в strand соединения
+			net::dispatch(stream_.get_executor(), beast::bind_front_handler(&Session::Read, shared_from_this()));
+		}
+
+	private:
+		void Read() {
+			parser_.emplace();
+			stream_.expires_after(IDLE_TIMEOUT);
+
+			// Сначала заголовок: лимит тела зависит от пути запроса
+			http::async_read_header(stream_, buffer_, *parser_,
+				beast::bind_front_handler(&Session::OnReadHeader, shared_from_this()));
+		}
+
+		void OnReadHeader(beast::error_code ec, size_t) {
+			if (ec) {
+				return OnError(ec);
+			}
+			const bool reload = parser_->get().target().starts_with("/api/reload");
+			parser_->body_limit(reload && enable_reload_ ? MAX_RELOAD_BODY_SIZE : MAX_BODY_SIZE);
+			http::async_read(stream_, buffer_, *parser_, beast::bind_front_handler(&Session::OnRead, shared_from_this()));
+		}
+
+		void OnRead(beast::error_code ec, size_t) {
+			if (ec) {
+				return OnError(ec);
+			}
+			response_ = HandleRequest(service_, parser_->release());
+			http::async_write(stream_, response_, beast::bind_front_handler(&Session::OnWrite, shared_from_this()));
+		}
+
+		void OnWrite(beast::error_code ec, size_t) {
+			if (ec) {
+				return OnError(ec);
+			}
+			if (response_.need_eof()) {
+				return Close();
+			}
+			Read();
+		}
+
+		void OnError(beast::error_code ec) {
+			// Клиент закрыл соединение или простаивал дольше IDLE_TIMEOUT — это штатное завершение
+			if (ec != http::error::end_of_stream && ec != beast::error::timeout && ec != net::error::eof) {
+				std::cerr << "Connection error: " << ec.message() << std::endl;
+			}
+			Close();
+		}
+
+		void Close() {
+			beast::error_code ec;
+			// Запрещаем дальнейшую отправку данных через сокет
+			stream_.socket().shutdown(tcp::socket::shutdown_send, ec);
+		}
+
+		beast::tcp_stream stream_;
+		beast::flat_buffer buffer_;  ///< Буфер для чтения данных в рамках текущей сессии
+		std::optional<http::request_parser<http::string_body>> parser_;
+		StringResponse response_;
+		server::QueryService& service_;
+		const bool enable_reload_;
+		std::atomic<size_t>& connections_;
+	};
+
+	/**
+	 * @brief Принимает соединения и создаёт для них сессии, пока их меньше max_connections.
+	 *
+	 * Сверх лимита соединение получает 503 и сразу закрывается.
+	 */
+	class Listener : public std::enable_shared_from_this<Listener> {
+	public:
+		Listener(net::io_context& ioc, const tcp::endpoint& endpoint, server::QueryService& service,
+			const Options& options)
+			: ioc_(ioc)
+			, acceptor_(net::make_strand(ioc), endpoint)
+			, service_(service)
+			, enable_reload_(options.enable_reload)
+			, max_connections_(options.max_connections) {
+		}
+
+		void Run() {
+			Accept();
+		}
+
+	private:
+		void Accept() {
+			// Каждое соединение получает свой strand: его операции не выполняются параллельно
+			acceptor_.async_accept(net::make_strand(ioc_), beast::bind_front_handler(&Listener::OnAccept, shared_from_this()));
+		}
+
+		void OnAccept(beast::error_code ec, tcp::socket socket) {
+			if (ec) {
+				std::cerr << "Accept error: " << ec.message() << std::endl;
+			}
+			else if (connections_.fetch_add(1, std::memory_order_relaxed) >= max_connections_) {
+				connections_.fetch_sub(1, std::memory_order_relaxed);
+				Reject(socket);
+			}
+			else {
+				std::make_shared<Session>(std::move(socket), service_, enable_reload_, connections_)->Run();
+			}
+			Accept();
+		}
+
+		// Короткий ответ 503 умещается в буфер сокета — запись не блокирует поток пула
+		static void Reject(tcp::socket& socket) {
+			StringResponse response(http::status::service_unavailable, 11);
+			response.set(http::field::content_type, "application/json");
+			response.body() = R"({"error_message":"too many connections"})";
+			response.prepare_payload();
+			response.keep_alive(false);
+
+			beast::error_code ec;
+			http::write(socket, response, ec);
+			socket.shutdown(tcp::socket::shutdown_both, ec);
+		}
+
+		net::io_context& ioc_;
+		tcp::acceptor acceptor_;
+		server::QueryService& service_;
+		const bool enable_reload_;
+		const size_t max_connections_;
+		std::atomic<size_t> connections_ = 0;  ///< Открытых соединений (уменьшает ~Session)
+	};
+
+} // namespace
+
+int main(int argc, char** argv) {
+	try {
+		const Options options = ParseOptions(argc, argv);
+
+		std::ifstream input_file(options.input_path);
+		if (!input_file) {
+			throw std::runtime_error("Cannot open " + options.input_path);
+		}
+
+		// Каталог и маршрутизатор строятся один раз — дальше каждый запрос стоит только своей обработки
+		server::QueryService service(json::Load(input_file), server::QueryServiceSettings{ options.enable_reload });
+
+		net::io_context ioc(static_cast<int>(options.threads));
+		const tcp::endpoint endpoint{ net::ip::make_address(options.address), options.port };
+		std::make_shared<Listener>(ioc, endpoint, service, options)->Run();
+		std::cerr << "Listening on " << options.address << ':' << options.port << " (" << options.threads
+			<< " threads, up to " << options.max_connections << " connections"
+			<< (options.enable_reload ? ", reload enabled" : "") << ')' << std::endl;
+
+		// Фиксированный пул: главный поток и threads - 1 рабочих выполняют обработчики всех соединений
+		std::vector<std::thread> workers;
+		workers.reserve(options.threads - 1);
+		for (size_t i = 1; i < options.threads; ++i) {
+			workers.emplace_back([&ioc] { ioc.run(); });
+		}
+		ioc.run();
+		for (auto& worker : workers) {
+			worker.join();
+		}
+	}
+	catch (const std::exception& e) {
+		std::cerr << "Error: " << e.what() << std::endl;
+		return 1;
+	}
+}
@@ -0,0 +1,191 @@
+#include "query_service.h"
+#include "../Transport_Directory/json_builder.h"
+#include "../Transport_Directory/profiler.h"
+
+#include <exception>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace server {
+
+	namespace {
+
+		constexpr unsigned HTTP_OK = 200;
+		constexpr unsigned HTTP_BAD_REQUEST = 400;
+		constexpr unsigned HTTP_FORBIDDEN = 403;
+		constexpr unsigned HTTP_NOT_FOUND = 404;
+		constexpr unsigned HTTP_METHOD_NOT_ALLOWED = 405;
+		constexpr unsigned HTTP_CONFLICT = 409;
+		constexpr unsigned HTTP_SERVICE_UNAVAILABLE = 503;
+
+		json::Document ParseBody(const std::string& body) {
+			std::istringstream in(body);
+			return json::Load(in);
+		}
+
+		// Текущий объём резидентной памяти процесса в мегабайтах (не пиковый: по нему видна утечка)
+		double CurrentRssMb() {
+#ifdef _WIN32
+			PROCESS_MEMORY_COUNTERS counters{};
+			GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters));
+			return static_cast<double>(counters.WorkingSetSize) / (1024.0 * 1024.0);
+#else
+			// /proc/self/statm: размер в страницах, затем резидентные страницы
+			std::ifstream statm("/proc/self/statm");
+			size_t size_pages = 0;
+			size_t resident_pages = 0;
+			statm >> size_pages >> resident_pages;
+			return static_cast<double>(resident_pages) * static_cast<double>(sysconf(_SC_PAGESIZE)) / (1024.0 * 1024.0);
+#endif
+		}
+
+	} // namespace
+
+	QueryService::QueryService(const json::Document& input, QueryServiceSettings settings)
+		: settings_(settings) {
+		store_.Rebuild(input);
+	}
+
+	HttpResult QueryService::Handle(std::string_view method, std::string_view target, const std::string& body) {
+		PROFILE_FUNCTION();
+		const std::string_view path = target.substr(0, target.find('?'));
+
+		// Маршрут → (метод, обработчик); неверный метод — 405 с перечнем допустимых
+		auto dispatch = [&](std::string_view expected, auto&& handler) {
+			if (method != expected) {
+				HttpResult result = MakeError(HTTP_METHOD_NOT_ALLOWED, "method not allowed");
+				result.allow = std::string(expected);
+				return result;
+			}
+			return handler();
+		};
+
+		try {
+			if (path == "/api/query") {
+				return dispatch("POST", [&] { return HandleQuery(body); });
+			}
+			if (path == "/api/diagnostics") {
+				return dispatch("GET", [&] { return HandleDiagnostics(); });
+			}
+			if (path == "/api/reload") {
+				return dispatch("POST", [&] { return HandleReload(body); });
+			}
+			if (path == "/health") {
+				return dispatch("GET", [&] { return HandleHealth(); });
+			}
+			return MakeError(HTTP_NOT_FOUND, "unknown path");
+		}
+		catch (const json::ParsingError& e) {
+			return MakeError(HTTP_BAD_REQUEST, std::string("invalid JSON: ") + e.what());
+		}
+		catch (const std::out_of_range&) {
+			// Dict::at в разборе запроса — нет обязательного поля ("id", "type", ...)
+			return MakeError(HTTP_BAD_REQUEST, "missing required field");
+		}
+		catch (const std::exception& e) {
+			return MakeError(HTTP_BAD_REQUEST, e.what());
+		}
+	}
+
+	HttpResult QueryService::HandleQuery(const std::string& body) const {
+		auto snapshot = store_.Acquire();
+		if (!snapshot) {
+			return MakeError(HTTP_SERVICE_UNAVAILABLE, "no data loaded");
+		}
+
+		// Один запрос — один ответ, массив запросов — массив ответов
+		const json::Document request = ParseBody(body);
+		const json::Node& root = request.GetRoot();
+		if (root.IsDict()) {
+			auto responses = snapshot->GetHandler().ProcessRequests(json::Array{ root });
+			return MakeJsonResult(HTTP_OK, json::Node(std::move(responses.front())));
+		}
+		if (!root.IsArray()) {
+			return MakeError(HTTP_BAD_REQUEST, "expected a request object or an array of requests");
+		}
+
+		auto responses = snapshot->GetHandler().ProcessRequests(root.AsArray());
+		return MakeJsonResult(HTTP_OK, json::Node(json::Array(
+			std::make_move_iterator(responses.begin()), std::make_move_iterator(responses.end()))));
+	}
+
+	HttpResult QueryService::HandleDiagnostics() const {
+		auto snapshot = store_.Acquire();
+		if (!snapshot) {
+			return MakeError(HTTP_SERVICE_UNAVAILABLE, "no data loaded");
+		}
+
+		json::Array request{ json::Node(json::Dict{
+			{ "id", json::Node(0) },
+			{ "type", json::Node(std::string("Diagnostics")) } }) };
+		auto responses = snapshot->GetHandler().ProcessRequests(request);
+		json::Dict diagnostics = std::move(responses.front());
+		diagnostics.emplace("process", json::Builder{}
+			.StartDict()
+			.Key("rss_mb").Value(CurrentRssMb())
+			.EndDict()
+			.Build());
+		return MakeJsonResult(HTTP_OK, json::Node(std::move(diagnostics)));
+	}
+
+	HttpResult QueryService::HandleReload(const std::string& body) {
+		if (!settings_.enable_reload) {
+			return MakeError(HTTP_FORBIDDEN, "reload is disabled (start the server with --enable-reload)");
+		}
+
+		// Сборка снимка занимает поток и память размером с ещё один каталог — не больше одной за раз
+		std::unique_lock lock(reload_mutex_, std::try_to_lock);
+		if (!lock) {
+			return MakeError(HTTP_CONFLICT, "reload already in progress");
+		}
+
+		// Новый снимок строится, пока запросы обслуживаются текущим
+		auto snapshot = store_.Rebuild(ParseBody(body));
+		return MakeJsonResult(HTTP_OK, json::Builder{}
+			.StartDict()
+			.Key("version").Value(static_cast<int>(snapshot->GetVersion()))
+			.EndDict()
+			.Build());
+	}
+
+	HttpResult QueryService::HandleHealth() const {
+		auto snapshot = store_.Acquire();
+		if (!snapshot) {
+			return MakeError(HTTP_SERVICE_UNAVAILABLE, "no data loaded");
+		}
+		return MakeJsonResult(HTTP_OK, json::Builder{}
+			.StartDict()
+			.Key("status").Value(std::string("ok"))
+			.Key("version").Value(static_cast<int>(snapshot->GetVersion()))
+			.EndDict()
+			.Build());
+	}
+
+	HttpResult QueryService::MakeJsonResult(unsigned status, const json::Node& node) {
+		std::ostringstream out;
+		json::Print(json::Document(node), out);
+
+		HttpResult result;
+		result.status = status;
+		result.body = std::move(out).str();
+		return result;
+	}
+
+	HttpResult QueryService::MakeError(unsigned status, std::string_view message) {
+		return MakeJsonResult(status, json::Builder{}
+			.StartDict()
+			.Key("error_message").Value(std::string(message))
+			.EndDict()
+			.Build());
+	}
+
+} // namespace server
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "../Transport_Directory/snapshot.h"
+
+#include <mutex>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief HTTP-интерфейс транспортного справочника без привязки к сетевой библиотеке.
+ *
+ * QueryService разбирает путь, метод и тело запроса и отвечает по текущему
+ * снимку справочника (snapshot::SnapshotStore). Каталог и маршрутизатор
+ * строятся один раз при загрузке, после чего каждый запрос стоит только
+ * собственной обработки. Методы потокобезопасны: каждый запрос закрепляет
+ * снимок, и перезагрузка данных не мешает выполняющимся запросам.
+ *
+ * Маршруты:
+ * - POST /api/query       — тело: массив stat_requests (или один запрос);
+ *                           ответ: массив ответов (или один ответ), как в пакетном режиме
+ * - GET  /api/diagnostics — стратегия маршрутизации, оценки памяти, статистика кэша,
+ *                           резидентная память процесса
+ * - POST /api/reload      — тело: полный входной документ; строит и публикует новый снимок.
+ *                           Только если разрешено (QueryServiceSettings::enable_reload),
+ *                           иначе 403; одновременно выполняется не больше одной перезагрузки (409)
+ * - GET  /health          — версия текущего снимка
+ */
+namespace server {
+
+	/// Ответ сервиса: код HTTP, тело и его тип
+	struct HttpResult {
+		unsigned status = 200;
+		std::string body;
+		std::string content_type = "application/json";
+		std::string allow;  ///< Допустимые методы (для 405 Method Not Allowed)
+	};
+
+	/// Настройки сервиса
+	struct QueryServiceSettings {
+		/// Разрешить POST /api/reload: перезагрузка заменяет данные и полностью занимает поток на время сборки
+		bool enable_reload = false;
+	};
+
+	class QueryService {
+	public:
+		/**
+		 * @brief Создаёт сервис и публикует снимок из входного документа.
+		 * @throw json::ParsingError при ошибках формата входного документа
+		 */
+		explicit QueryService(const json::Document& input, QueryServiceSettings settings = {});
+
+		/**
+		 * @brief Обрабатывает HTTP-запрос.
+		 * @param method Метод ("GET", "POST", ...)
+		 * @param target Путь запроса (строка запроса после '?' игнорируется)
+		 * @param body Тело запроса
+		 */
+		HttpResult Handle(std::string_view method, std::string_view target, const std::string& body);
+
+	private:
+		HttpResult HandleQuery(const std::string& body) const;
+		HttpResult HandleDiagnostics() const;
+		HttpResult HandleReload(const std::string& body);
+		HttpResult HandleHealth() const;
+
+		static HttpResult MakeJsonResult(unsigned status, const json::Node& node);
+		static HttpResult MakeError(unsigned status, std::string_view message);
+
+		QueryServiceSettings settings_;
+		snapshot::SnapshotStore store_;
+		std::mutex reload_mutex_;  ///< Занят на время перезагрузки
+	};
+
+} // namespace server
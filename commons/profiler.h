@@ -0,0 +1,378 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/*
+ * Иерархический профилировщик с теми же удобствами, что и LOG_DURATION.
+ *
+ * LOG_DURATION печатает строку на каждый выход из области видимости — на горячих
+ * путях, которые выполняются миллионы раз, это бесполезно. PROFILE_SCOPE вместо
+ * печати копит статистику: число вызовов, суммарное/минимальное/максимальное время
+ * и гистограмму для перцентилей (всё в наносекундах). Вложенные области образуют
+ * дерево (как во flame graph): одна и та же функция, вызванная из разных мест,
+ * учитывается в разных узлах.
+ *
+ * Использование:
+ *     void Foo() {
+ *         PROFILE_FUNCTION();              // имя области — имя функции
+ *         {
+ *             PROFILE_SCOPE("Foo: loop");  // только строковые литералы
+ *             ...
+ *         }
+ *     }
+ *
+ * Отчёт выводится при завершении программы, если задана переменная окружения:
+ *     PROFILER_REPORT=1       — текстовое дерево в stderr
+ *     PROFILER_JSON=path.json — то же дерево в JSON-файл
+ * Явно: profiler::PrintReport(std::cerr), profiler::PrintJsonReport(out).
+ *
+ * Каждый поток пишет в своё дерево (thread_local) без блокировок; деревья
+ * потоков объединяются только при построении отчёта. Строить отчёт следует,
+ * когда профилируемые потоки уже завершились (или хотя бы простаивают).
+ *
+ * Определите PROFILER_DISABLED, чтобы макросы превратились в пустые операторы.
+ */
+
+#define PROFILER_CONCAT_INTERNAL(X, Y) X##Y
+#define PROFILER_CONCAT(X, Y) PROFILER_CONCAT_INTERNAL(X, Y)
+#define UNIQUE_VAR_NAME_PROFILER PROFILER_CONCAT(profilerScope, __LINE__)
+
+#ifdef PROFILER_DISABLED
+#define PROFILE_SCOPE(name) ((void)0)
+#define PROFILE_FUNCTION() ((void)0)
+#else
+#define PROFILE_SCOPE(name) profiler::ScopeGuard UNIQUE_VAR_NAME_PROFILER(name)
+#define PROFILE_FUNCTION() profiler::ScopeGuard UNIQUE_VAR_NAME_PROFILER(__func__)
+#endif
+
+namespace profiler {
+
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Статистика одной области: счётчики и логарифмическая гистограмма.
+     *
+     * Гистограмма: по 4 корзины на каждую степень двойки, т.е. относительная
+     * погрешность перцентилей не превышает 25%, а размер фиксирован.
+     */
+    struct ScopeStats {
+        static constexpr size_t SUB_BUCKETS = 4;
+        static constexpr size_t BUCKET_COUNT = 63 * SUB_BUCKETS;
+
+        uint64_t count = 0;
+        uint64_t total_ns = 0;
+        uint64_t min_ns = std::numeric_limits<uint64_t>::max();
+        uint64_t max_ns = 0;
+        std::array<uint64_t, BUCKET_COUNT> histogram{};
+
+        void Add(uint64_t ns) {
+            ++count;
+            total_ns += ns;
+            min_ns = std::min(min_ns, ns);
+            max_ns = std::max(max_ns, ns);
+            ++histogram[BucketIndex(ns)];
+        }
+
+        void Merge(const ScopeStats& other) {
+            count += other.count;
+            total_ns += other.total_ns;
+            min_ns = std::min(min_ns, other.min_ns);
+            max_ns = std::max(max_ns, other.max_ns);
+            for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+                histogram[i] += other.histogram[i];
+            }
+        }
+
+        // Перцентиль q ∈ [0, 1] — середина корзины, в которую он попал
+        uint64_t Percentile(double q) const {
+            if (count == 0) {
+                return 0;
+            }
+            const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(q * static_cast<double>(count) + 0.5));
+            uint64_t seen = 0;
+            for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+                seen += histogram[i];
+                if (seen >= rank) {
+                    return std::clamp((BucketLowerBound(i) + BucketLowerBound(i + 1)) / 2, min_ns, max_ns);
+                }
+            }
+            return max_ns;
+        }
+
+        uint64_t Mean() const {
+            return count ? total_ns / count : 0;
+        }
+
+        // Корзины 0..3 — точные значения 0..3 нс, далее по 4 на каждую степень двойки
+        static size_t BucketIndex(uint64_t ns) {
+            if (ns < SUB_BUCKETS) {
+                return static_cast<size_t>(ns);
+            }
+            const int msb = std::bit_width(ns) - 1;  // >= 2
+            const uint64_t sub = (ns >> (msb - 2)) & (SUB_BUCKETS - 1);
+            return std::min(BUCKET_COUNT - 1, static_cast<size_t>(msb - 1) * SUB_BUCKETS + static_cast<size_t>(sub));
+        }
+
+        static uint64_t BucketLowerBound(size_t index) {
+            if (index < SUB_BUCKETS) {
+                return index;
+            }
+            const size_t msb = index / SUB_BUCKETS + 1;
+            const uint64_t sub = index % SUB_BUCKETS;
+            return (SUB_BUCKETS + sub) << (msb - 2);
+        }
+    };
+
+    /**
+     * @brief Дерево областей одного потока.
+     *
+     * Узел 0 — корень (сам поток). Узлы хранятся в векторе и ссылаются друг на друга
+     * по индексам, поэтому рост вектора не портит открытые области.
+     */
+    class ThreadTree {
+    public:
+        struct Node {
+            const char* name;
+            size_t parent;
+            std::vector<size_t> children;
+            ScopeStats stats;
+        };
+
+        ThreadTree() {
+            nodes_.push_back(Node{ "thread", 0, {}, {} });
+        }
+
+        // Входит в дочернюю область name текущего узла (создаёт её при первом входе)
+        void Enter(const char* name) {
+            Node& current = nodes_[current_];
+
+            // Обычно литерал один и тот же — сначала сравниваем указатели
+            for (size_t child : current.children) {
+                if (nodes_[child].name == name) {
+                    current_ = child;
+                    return;
+                }
+            }
+            for (size_t child : current.children) {
+                if (std::strcmp(nodes_[child].name, name) == 0) {
+                    current_ = child;
+                    return;
+                }
+            }
+
+            const size_t index = nodes_.size();
+            nodes_[current_].children.push_back(index);
+            nodes_.push_back(Node{ name, current_, {}, {} });
+            current_ = index;
+        }
+
+        // Выходит из текущей области, учитывая её длительность
+        void Leave(uint64_t ns) {
+            Node& node = nodes_[current_];
+            node.stats.Add(ns);
+            current_ = node.parent;
+        }
+
+        const std::vector<Node>& GetNodes() const {
+            return nodes_;
+        }
+
+    private:
+        std::vector<Node> nodes_;
+        size_t current_ = 0;
+    };
+
+    /**
+     * @brief Узел объединённого отчёта (области потоков сведены по пути имён).
+     */
+    struct ReportNode {
+        std::string name;
+        ScopeStats stats;
+        std::vector<ReportNode> children;
+
+        ReportNode& Child(const std::string& child_name) {
+            for (ReportNode& child : children) {
+                if (child.name == child_name) {
+                    return child;
+                }
+            }
+            children.push_back(ReportNode{ child_name, {}, {} });
+            return children.back();
+        }
+    };
+
+    /**
+     * @brief Реестр деревьев всех потоков; при уничтожении печатает отчёт (см. переменные окружения).
+     */
+    class Registry {
+    public:
+        static Registry& Instance() {
+            static Registry registry;
+            return registry;
+        }
+
+        std::shared_ptr<ThreadTree> Register() {
+            auto tree = std::make_shared<ThreadTree>();
+            std::lock_guard guard(mutex_);
+            trees_.push_back(tree);
+            return tree;
+        }
+
+        // Сводит деревья потоков в одно
+        ReportNode BuildReport() const {
+            ReportNode root{ "total", {}, {} };
+            std::lock_guard guard(mutex_);
+            for (const auto& tree : trees_) {
+                MergeTree(*tree, 0, root);
+            }
+            return root;
+        }
+
+        ~Registry() {
+            if (const char* report = std::getenv("PROFILER_REPORT"); report && *report && *report != '0') {
+                PrintText(BuildReport(), std::cerr);
+            }
+            if (const char* path = std::getenv("PROFILER_JSON"); path && *path) {
+                std::ofstream out(path);
+                PrintJson(BuildReport(), out);
+            }
+        }
+
+        static void PrintText(const ReportNode& root, std::ostream& out) {
+            out << std::left << std::setw(48) << "scope" << std::right
+                << std::setw(12) << "calls" << std::setw(14) << "total, ms"
+                << std::setw(12) << "mean, ns" << std::setw(12) << "min, ns"
+                << std::setw(12) << "p50, ns" << std::setw(12) << "p90, ns"
+                << std::setw(12) << "p99, ns" << std::setw(14) << "max, ns" << '\n';
+            for (const ReportNode& child : root.children) {
+                PrintTextNode(child, 0, out);
+            }
+        }
+
+        static void PrintJson(const ReportNode& root, std::ostream& out) {
+            PrintJsonNode(root, out);
+            out << '\n';
+        }
+
+    private:
+        Registry() = default;
+
+        static void MergeTree(const ThreadTree& tree, size_t index, ReportNode& target) {
+            for (size_t child : tree.GetNodes()[index].children) {
+                const auto& node = tree.GetNodes()[child];
+                ReportNode& merged = target.Child(node.name);
+                merged.stats.Merge(node.stats);
+                MergeTree(tree, child, merged);
+            }
+        }
+
+        static void PrintTextNode(const ReportNode& node, int depth, std::ostream& out) {
+            const auto& s = node.stats;
+            out << std::left << std::setw(48) << (std::string(2 * depth, ' ') + node.name) << std::right
+                << std::setw(12) << s.count
+                << std::setw(14) << std::fixed << std::setprecision(3) << static_cast<double>(s.total_ns) / 1e6
+                << std::setw(12) << s.Mean()
+                << std::setw(12) << (s.count ? s.min_ns : 0)
+                << std::setw(12) << s.Percentile(0.5)
+                << std::setw(12) << s.Percentile(0.9)
+                << std::setw(12) << s.Percentile(0.99)
+                << std::setw(14) << s.max_ns << '\n';
+            for (const ReportNode& child : node.children) {
+                PrintTextNode(child, depth + 1, out);
+            }
+        }
+
+        static void PrintJsonString(const std::string& text, std::ostream& out) {
+            out << '"';
+            for (char c : text) {
+                if (c == '"' || c == '\\') {
+                    out << '\\';
+                }
+                out << c;
+            }
+            out << '"';
+        }
+
+        static void PrintJsonNode(const ReportNode& node, std::ostream& out) {
+            const auto& s = node.stats;
+            out << "{\"name\":";
+            PrintJsonString(node.name, out);
+            out << ",\"calls\":" << s.count
+                << ",\"total_ns\":" << s.total_ns
+                << ",\"mean_ns\":" << s.Mean()
+                << ",\"min_ns\":" << (s.count ? s.min_ns : 0)
+                << ",\"p50_ns\":" << s.Percentile(0.5)
+                << ",\"p90_ns\":" << s.Percentile(0.9)
+                << ",\"p99_ns\":" << s.Percentile(0.99)
+                << ",\"max_ns\":" << s.max_ns
+                << ",\"children\":[";
+            bool first = true;
+            for (const ReportNode& child : node.children) {
+                if (!first) {
+                    out << ',';
+                }
+                first = false;
+                PrintJsonNode(child, out);
+            }
+            out << "]}";
+        }
+
+        mutable std::mutex mutex_;
+        std::vector<std::shared_ptr<ThreadTree>> trees_;  ///< Переживают свои потоки — данные не теряются
+    };
+
+    // Дерево текущего потока (регистрируется при первом обращении)
+    inline ThreadTree& CurrentThreadTree() {
+        thread_local std::shared_ptr<ThreadTree> tree = Registry::Instance().Register();
+        return *tree;
+    }
+
+    /// Выводит текстовый отчёт по всем потокам
+    inline void PrintReport(std::ostream& out) {
+        Registry::PrintText(Registry::Instance().BuildReport(), out);
+    }
+
+    /// Выводит отчёт по всем потокам в формате JSON
+    inline void PrintJsonReport(std::ostream& out) {
+        Registry::PrintJson(Registry::Instance().BuildReport(), out);
+    }
+
+    /**
+     * @brief RAII-замер области: вход в конструкторе, учёт длительности в деструкторе.
+     */
+    class ScopeGuard {
+    public:
+        explicit ScopeGuard(const char* name)
+            : tree_(CurrentThreadTree()) {
+            tree_.Enter(name);
+            start_time_ = Clock::now();
+        }
+
+        ScopeGuard(const ScopeGuard&) = delete;
+        ScopeGuard& operator=(const ScopeGuard&) = delete;
+
+        ~ScopeGuard() {
+            const auto dur = Clock::now() - start_time_;
+            tree_.Leave(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(dur).count()));
+        }
+
+    private:
+        ThreadTree& tree_;
+        Clock::time_point start_time_;
+    };
+
+} // namespace profiler